@@ -1,4 +1,8 @@
+#ifndef CPPTASKS__BIGINTEGER_H_
+#define CPPTASKS__BIGINTEGER_H_
+
 #include <assert.h>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -6,6 +10,19 @@
 #include <algorithm>
 #include <compare>
 #include <numeric>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <bit>
+#include <cstring>
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define BIGINTEGER_AVX2
+#endif
 
 using std::cin;
 using std::cout;
@@ -33,632 +50,3510 @@ Sign operator*(const Sign& sign1, const Sign& sign2) {
   return ans;
 }
 
-struct BigInteger;
+// вектор тривиально копируемых элементов, первые kInline из которых лежат прямо в объекте,
+// а в кучу он переезжает только когда вырастает больше
+template <typename T, size_t kInline>
+class SmallVector {
+  static_assert(std::is_trivially_copyable_v<T>);
 
-bool operator<(const BigInteger& num1, const BigInteger& num2);
+  T local[kInline] = {};
+  T* heap = nullptr;
+  size_t length = 0;
+  size_t reserved = kInline;
 
-bool operator>(const BigInteger& num1, const BigInteger& num2);
+  void grow(size_t new_reserved) {
+    T* new_heap = new T[new_reserved];
+    std::copy(data(), data() + length, new_heap);
+    delete[] heap;
+    heap = new_heap;
+    reserved = new_reserved;
+  }
 
-bool operator<=(const BigInteger& num1, const BigInteger& num2);
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
 
-bool operator>=(const BigInteger& num1, const BigInteger& num2);
+  SmallVector() = default;
 
-bool operator==(const BigInteger& num1, const BigInteger& num2);
+  explicit SmallVector(size_t count, const T& value = T()) {
+    resize(count, value);
+  }
 
-bool operator!=(const BigInteger& num1, const BigInteger& num2);
+  template <typename Iterator>
+  SmallVector(Iterator first, Iterator last) {
+    assign(first, last);
+  }
 
-struct BigInteger {
-  static const int64_t kBase = 1e9;
-  vector<int32_t> number;
-  Sign signum;
+  SmallVector(const SmallVector& other) {
+    assign(other.begin(), other.end());
+  }
 
-  string toString() const {
-    string string_value;
-    if (signum == Sign::Negative) {
-      string_value = "-";
-    }
-    if (signum == Sign::Null || number.empty()) {
-      string_value = "0";
-      return string_value;
-    }
-    string_value += std::to_string(number[number.size() - 1]);
-    for (int i = number.size() - 2; i >= 0; i--) {
-      int64_t value = number[i];
-      int64_t max_d = kBase / 10;
-      while (max_d > value) {
-        string_value += "0";
-        max_d /= 10;
-      }
-      if (value != 0) {
-        string_value += std::to_string(value);
-      }
-    }
-    return string_value;
+  SmallVector(SmallVector&& other) noexcept {
+    *this = std::move(other);
   }
 
-  BigInteger() {
-    signum = Sign::Null;
-    number.clear();
+  ~SmallVector() {
+    delete[] heap;
   }
 
-  BigInteger(int input_number) {
-    signum = Sign::Positive;
-    if (input_number == 0) {
-      signum = Sign::Null;
+  SmallVector& operator=(const SmallVector& other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
     }
-    if (input_number < 0) {
-      signum = Sign::Negative;
-      input_number *= -1;
+    return *this;
+  }
+
+  // буфер из кучи забираем целиком, маленький вектор просто копируем к себе
+  SmallVector& operator=(SmallVector&& other) noexcept {
+    if (this == &other) {
+      return *this;
     }
-    number.clear();
-    if (input_number >= kBase) {
-      number.push_back(input_number % kBase);
-      number.push_back(input_number / kBase);
+    if (other.heap != nullptr) {
+      delete[] heap;
+      heap = other.heap;
+      length = other.length;
+      reserved = other.reserved;
+      other.heap = nullptr;
+      other.reserved = kInline;
     } else {
-      number.push_back(input_number);
+      assign(other.begin(), other.end());
     }
+    other.length = 0;
+    return *this;
   }
 
-  BigInteger(string str) {
-    toNull();
-    signum = Sign::Positive;
-    if (!str.empty() && str[0] == '-') {
-      signum = Sign::Negative;
-      str = str.substr(1, str.size() - 1);
+  // data() смотрит либо в heap, либо в local, поэтому достаточно обменять все поля
+  void swap(SmallVector& other) {
+    std::swap(local, other.local);
+    std::swap(heap, other.heap);
+    std::swap(length, other.length);
+    std::swap(reserved, other.reserved);
+  }
+
+  size_t size() const { return length; }
+
+  bool empty() const { return length == 0; }
+
+  size_t capacity() const { return reserved; }
+
+  T* data() { return heap != nullptr ? heap : local; }
+
+  const T* data() const { return heap != nullptr ? heap : local; }
+
+  T* begin() { return data(); }
+
+  T* end() { return data() + length; }
+
+  const T* begin() const { return data(); }
+
+  const T* end() const { return data() + length; }
+
+  T& operator[](size_t pos) { return data()[pos]; }
+
+  const T& operator[](size_t pos) const { return data()[pos]; }
+
+  T& back() { return data()[length - 1]; }
+
+  const T& back() const { return data()[length - 1]; }
+
+  void reserve(size_t count) {
+    if (count > reserved) {
+      grow(count);
     }
-    for (unsigned i = 0; i < str.size(); i++) {
-      if (str[i] > '9' || str[i] < '0') {
-        str = str.substr(0, i);
-      }
+  }
+
+  void resize(size_t count, const T& value = T()) {
+    reserve(count);
+    if (count > length) {
+      std::fill(data() + length, data() + count, value);
     }
-    number.push_back(0);
-    std::reverse(str.begin(), str.end());
-    int ind = 0;
-    int64_t degree = 1;
-    for (unsigned i = 0; i < str.size(); i++) {
-      number[ind] += degree * (str[i] - '0');
-      degree *= 10;
-      if (degree == BigInteger::kBase) {
-        degree = 1;
-        ind += 1;
-        number.push_back(0);
-      }
+    length = count;
+  }
+
+  void push_back(const T& value) {
+    T copy = value;
+    if (length == reserved) {
+      grow(2 * reserved);
     }
-    clearNulls();
+    data()[length++] = copy;
   }
 
-  explicit operator bool() {
-    return (signum != Sign::Null);
+  void pop_back() {
+    length -= 1;
   }
 
-  void toNull() {
-    number.clear();
-    signum = Sign::Null;
+  void clear() {
+    length = 0;
   }
 
-  void clearNulls() {
-    for (size_t i = 0; i < number.size(); i++) {
-      size_t ind = number.size() - 1 - i;
-      if (number[ind] == 0) {
-        number.pop_back();
-      } else {
-        break;
-      }
-    }
-    if (number.empty()) {
-      signum = Sign::Null;
+  template <typename Iterator>
+  void assign(Iterator first, Iterator last) {
+    size_t count = std::distance(first, last);
+    if (count > reserved) {
+      length = 0;
+      grow(count);
     }
+    std::copy(first, last, data());
+    length = count;
   }
 
-  void swap(BigInteger& integer) {
-    std::swap(number, integer.number);
-    std::swap(signum, integer.signum);
+  void insert(T* pos, size_t count, const T& value) {
+    size_t offset = pos - data();
+    if (length + count > reserved) {
+      grow(std::max(length + count, 2 * reserved));
+    }
+    std::copy_backward(data() + offset, data() + length, data() + length + count);
+    std::fill(data() + offset, data() + offset + count, value);
+    length += count;
   }
 
-  BigInteger subInt(int len, int pos) {
-    BigInteger ans(0);
-    ans.signum = this->signum;
-    ans.number.resize(len);
-    for (int i = pos; i < pos + len; i++) {
-      ans.number[i - pos] = this->number[i];
+  template <typename Iterator>
+  void insert(T* pos, Iterator first, Iterator last) {
+    size_t offset = pos - data();
+    size_t count = std::distance(first, last);
+    if (length + count > reserved) {
+      grow(std::max(length + count, 2 * reserved));
     }
-    return ans;
+    std::copy_backward(data() + offset, data() + length, data() + length + count);
+    std::copy(first, last, data() + offset);
+    length += count;
   }
 
-  BigInteger upper(int len) {
-    std::reverse(number.begin(), number.end());
-    for (int i = 0; i < len; i++) {
-      number.push_back(0);
-    }
-    std::reverse(number.begin(), number.end());
-    return *this;
+  void erase(T* first, T* last) {
+    std::copy(last, end(), first);
+    length -= last - first;
   }
+};
 
-  BigInteger& operator-=(const BigInteger& num) {
-    if (num.signum == Sign::Null) {
-      return *this;
-    }
-    if (signum == Sign::Null) {
-      *this = num;
-      signum *= Sign::Negative;
-      return *this;
-    }
-    if (signum != num.signum) {
-      signum *= Sign::Negative;
-      *this += num;
-      signum *= Sign::Negative;
-      return *this;
-    }
-    if (num == *this) {
-      toNull();
-      return *this;
+// постоянные потоки для parallelFor: NTT зовёт его на каждом этапе бабочек, и новые std::thread на каждый
+// вызов (по biginteger_bench threads) стоили бы десятки микросекунд на поток при этапах в сотни микросекунд.
+// Пул дорастает до самого большого запрошенного числа потоков; задания не ждут друг друга, поэтому
+// parallelFor из нескольких потоков сразу (как в productTree) просто делят очередь
+class WorkerPool {
+ public:
+  static WorkerPool& instance() {
+    static WorkerPool pool;
+    return pool;
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
     }
-    if ((signum == Sign::Positive) != (num < *this)) {
-      *this = -(num - *this);
-      return *this;
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+      worker.join();
     }
+  }
 
-    // после всех проверок выше мы работаем с двумя ненулевыми числами одного знака, притом *this по модулю больше чем num
-    int64_t buffer = 0;
-    size_t length = number.size();
-    for (size_t i = 0; i < length; i++) {
-      int64_t num_number_i = 0;
-      if (num.number.size() > i) {
-        num_number_i = num.number[i];
-      }
-      int64_t diff = number[i] - buffer - num_number_i;
-      if (diff < 0) {
-        number[i] = kBase + diff;
-        buffer = 1;
-      } else {
-        number[i] = diff;
-        buffer = 0;
+  // job выполнится в одном из не меньше чем threads потоков пула
+  void submit(std::function<void()> job, size_t threads) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      while (workers.size() < threads) {
+        workers.emplace_back([this] { work(); });
       }
+      jobs.push_back(std::move(job));
     }
-    clearNulls();
-    if (number.empty()) {
-      signum = Sign::Null;
+    wake.notify_one();
+  }
+
+ private:
+  WorkerPool() = default;
+
+  void work() {
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+          return;
+        }
+        job = std::move(jobs.front());
+        jobs.pop_front();
+      }
+      job();
     }
-    return *this;
   }
 
-  BigInteger& operator+=(BigInteger num) {
-    if (num.signum == Sign::Null) {
-      return *this;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<std::function<void()>> jobs;
+  vector<std::thread> workers;
+  bool stopping = false;
+};
+
+// политики цифр BasicBigInteger: тип цифры, тип двойной ширины для переносов и основание.
+// Основание - всегда 2^(число бит цифры): на этом держатся AVX2, NTT, Лемер, Монтгомери и двоичный формат
+#ifdef __SIZEOF_INT128__
+struct Limbs64 {
+  using Limb = uint64_t;
+  using DoubleLimb = unsigned __int128;
+  static constexpr DoubleLimb kBase = DoubleLimb(1) << 64;
+  // biginteger_bench thresholds: NTT в одном потоке обгоняет Тума-Кука с 28000-32000 цифр (три прогона)
+  static const size_t kNttThreshold = 32000;
+};
+#endif
+
+struct Limbs32 {
+  using Limb = uint32_t;
+  using DoubleLimb = uint64_t;
+  static constexpr DoubleLimb kBase = DoubleLimb(1) << 32;
+  // biginteger_bench thresholds: NTT быстрее Тума-Кука с 4000 цифр во всех трёх прогонах (при 3000 - на 15%
+  // медленнее); 32-битные цифры дешевле режутся на куски NTT, а столбик на них вдвое дороже 64-битного
+  static const size_t kNttThreshold = 4000;
+};
+
+// политика по умолчанию: 64-битные цифры там, где компилятор умеет 128-битное умножение, иначе 32-битные
+// (biginteger_bench policy, x86-64, три прогона: на умножении, делении, выводе и НОД 64-битные цифры
+// быстрее в 1.1-2 раза на 100 десятичных знаках и в 1.4-3.5 раза от 1000 до 100000 знаков);
+// можно переопределить, например -DBIGINTEGER_LIMB_POLICY=Limbs32
+#ifndef BIGINTEGER_LIMB_POLICY
+#ifdef __SIZEOF_INT128__
+#define BIGINTEGER_LIMB_POLICY Limbs64
+#else
+#define BIGINTEGER_LIMB_POLICY Limbs32
+#endif
+#endif
+
+template <typename LimbPolicy>
+struct BasicBigInteger {
+  // цифры двоичные, переносы считаются в DoubleLimb двойной ширины,
+  // в десятичную систему число переводится только при вводе и выводе
+  using Limb = typename LimbPolicy::Limb;
+  using DoubleLimb = typename LimbPolicy::DoubleLimb;
+
+  static constexpr DoubleLimb kBase = LimbPolicy::kBase;
+  static constexpr size_t kLimbBits = 8 * sizeof(Limb);
+  static_assert(std::is_unsigned_v<Limb> && sizeof(DoubleLimb) == 2 * sizeof(Limb) &&
+                kBase - 1 == static_cast<Limb>(-1), "основание должно быть 2^(число бит цифры)");
+  // пороги ниже сверены с biginteger_bench thresholds (x86-64, g++ -O2, лучшая из 7 чередующихся серий,
+  // три прогона на одном ядре), где каждый алгоритм сравнивается с предыдущим на верхнем уровне рекурсии.
+  // Начиная с этой длины (в цифрах) умножение идёт по Карацубе: для Limbs64 с 20 цифр она не медленнее
+  // столбика, для Limbs32 они примерно равны до 32 цифр, а с 48 Карацуба быстрее на 10-20% для обеих
+  static const size_t kKaratsubaThreshold = 20;
+  // квадрат столбиком вдвое дешевле произведения, поэтому Карацуба для него включается позже:
+  // с 40 цифр для Limbs64 и около 96 для Limbs32, порог общий по более частой 64-битной политике
+  static const size_t kKaratsubaSquareThreshold = 40;
+  // начиная с этой длины (в цифрах) равные по длине множители перемножаются по Туму-Куку на три части:
+  // ниже 300 он медленнее Карацубы на 5-40%, от 300 до 800 цифр они в пределах нескольких процентов
+  static const size_t kToom3Threshold = 300;
+  // начиная с этой длины меньшего множителя умножение идёт через NTT; своя у каждой политики
+  static const size_t kNttThreshold = LimbPolicy::kNttThreshold;
+  // модули NTT: c * 2^k + 1 с первообразным корнем 3, размер преобразования не больше 2^23
+  static const uint32_t kNttMod1 = 998244353;
+  static const uint32_t kNttMod2 = 167772161;
+  static const uint32_t kNttMod3 = 469762049;
+  // в NTT каждая цифра режется на kNttChunksPerLimb кусков по основанию kNttChunkBase
+  static const uint64_t kNttChunkBase = uint64_t(1) << 32;
+  static const size_t kNttChunksPerLimb = sizeof(Limb) / 4;
+  static const size_t kNttMaxLength = (size_t(1) << 23) / kNttChunksPerLimb;
+  // начиная с этой длины делителя и частного деление идёт через обратное по Ньютону
+  static const size_t kNewtonDivisionThreshold = 600;
+  // десятичный ввод и вывод идёт блоками по kChunkDigits цифр
+  static const uint32_t kChunkBase = 1000000000;
+  static const size_t kChunkDigits = 9;
+  // числа до этой длины переводятся в десятичную систему и обратно за квадрат,
+  // длиннее - делением пополам по степеням kChunkBase^(2^k)
+  static const size_t kConversionThreshold = 32;
+  // в алгоритме Лемера старшие цифры приближаются числами меньше kLehmerBound,
+  // тогда коэффициенты матрицы шага умещаются и в int64_t, и в Limb
+  static constexpr DoubleLimb kLehmerBound = kBase / 4;
+
+  // число потоков для умножения длинных чисел и длина меньшего множителя, начиная с которой они
+  // включаются; потоки делят между собой бабочки NTT и сборку результата. По biginteger_bench threads
+  // NTT 20000 цифр занимает около 38 мс, а его примерно 60 вызовов parallelFor на WorkerPool из 8 потоков -
+  // меньше 1 мс (новые std::thread на каждый вызов стоили бы около 7 мс), так что с этой длины
+  // накладные расходы на потоки не больше нескольких процентов
+  static size_t& multiplicationThreads() {
+    static size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    return threads;
+  }
+  static size_t& parallelThreshold() {
+    static size_t threshold = 20000;
+    return threshold;
+  }
+  // сколько потоков может занять умножение, запущенное из этого потока: productTree делит их между
+  // поддеревьями, чтобы NTT внутри параллельного поддерева не запускало ещё multiplicationThreads()
+  static size_t& threadBudget() {
+    thread_local size_t budget = SIZE_MAX;
+    return budget;
+  }
+  static size_t nttThreads(size_t len) {
+    if (len < parallelThreshold()) {
+      return 1;
     }
-    if (signum == Sign::Null) {
-      swap(num);
-      return *this;
+    return (threadBudget() < multiplicationThreads() ? threadBudget() : multiplicationThreads());
+  }
+
+  // начиная с этой длины сложение и вычитание 64-битных цифр идут по четыре в AVX2, если процессор его умеет
+  // и simdAdditions() не выключено (тест сравнивает так оба пути); по biginteger_bench carries на x86-64
+  // AVX2 не медленнее скалярного цикла уже с 8 цифр, а с 16 стабильно быстрее в 1.3-2 раза
+  static const size_t kSimdThreshold = 16;
+  static bool& simdAdditions() {
+    static bool enabled = true;
+    return enabled;
+  }
+
+  // числа до kInlineLimbs цифр не ходят в кучу
+  static const size_t kInlineLimbs = 4;
+  using LimbVector = SmallVector<Limb, kInlineLimbs>;
+
+  LimbVector number;
+  Sign signum;
+
+  // ядра над сырыми массивами цифр (младшие разряды первыми)
+
+#ifdef BIGINTEGER_AVX2
+  static bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+  }
+
+  // переносы между четырьмя дорожками считаются как в сумматоре с ускоренным переносом: по маскам
+  // gen (дорожка сама даёт перенос) и prop (пропускает входящий) одно скалярное сложение
+  // (gen | prop) + gen + carry даёт все входящие переносы сразу; возвращает маску входящих
+  // переносов, в carry остаётся перенос из старшей дорожки
+  static unsigned lookaheadCarries(unsigned gen, unsigned prop, unsigned& carry) {
+    unsigned total = (gen | prop) + gen + carry;
+    carry = total >> 4;
+    return (total ^ (gen | prop) ^ gen) & 15;
+  }
+
+  // res[0, len) = a + b по четыре цифры, возвращает перенос; res может совпадать с a или b
+  __attribute__((target("avx2"))) static Limb addLimbsAvx2(Limb* res, const Limb* a, const Limb* b, size_t len) {
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i all_ones = _mm256_set1_epi64x(-1);
+    const __m256i lanes = _mm256_set_epi64x(3, 2, 1, 0);
+    const __m256i one = _mm256_set1_epi64x(1);
+    unsigned carry = 0;
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+      __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+      __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+      __m256i sum = _mm256_add_epi64(va, vb);
+      // перенос рождается, если sum < a (беззнаково), и проходит насквозь, если sum = kBase - 1
+      __m256i gen = _mm256_cmpgt_epi64(_mm256_xor_si256(va, sign), _mm256_xor_si256(sum, sign));
+      __m256i prop = _mm256_cmpeq_epi64(sum, all_ones);
+      unsigned carries = lookaheadCarries(_mm256_movemask_pd(_mm256_castsi256_pd(gen)),
+                                          _mm256_movemask_pd(_mm256_castsi256_pd(prop)), carry);
+      __m256i add = _mm256_and_si256(_mm256_srlv_epi64(_mm256_set1_epi64x(carries), lanes), one);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(res + i), _mm256_add_epi64(sum, add));
     }
-    if (signum != num.signum) {
-      signum *= Sign::Negative;
-      *this -= num;
-      signum *= Sign::Negative;
-      return *this;
+    for (; i < len; i++) {
+      DoubleLimb sum = static_cast<DoubleLimb>(a[i]) + b[i] + carry;
+      res[i] = static_cast<Limb>(sum % kBase);
+      carry = static_cast<unsigned>(sum / kBase);
     }
-    // сложение двух чисел одного знака
-    int64_t buffer = 0;
-    size_t length = std::min(num.number.size(), number.size());
-    //сложение до последней цифры кратчайшего
-    for (size_t i = 0; i < length; i++) {
-      int64_t sum = buffer + num.number[i] + number[i];
-      if (sum >= kBase) {
-        number[i] = sum - kBase;
-        buffer = 1;
-      } else {
-        number[i] = sum;
-        buffer = 0;
-      }
+    return carry;
+  }
+
+  // res[0, len) = a - b по четыре цифры, возвращает заём; res может совпадать с a или b
+  __attribute__((target("avx2"))) static Limb subLimbsAvx2(Limb* res, const Limb* a, const Limb* b, size_t len) {
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lanes = _mm256_set_epi64x(3, 2, 1, 0);
+    const __m256i one = _mm256_set1_epi64x(1);
+    unsigned borrow = 0;
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+      __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+      __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+      __m256i diff = _mm256_sub_epi64(va, vb);
+      // заём рождается, если a < b (беззнаково), и проходит насквозь, если diff = 0
+      __m256i gen = _mm256_cmpgt_epi64(_mm256_xor_si256(vb, sign), _mm256_xor_si256(va, sign));
+      __m256i prop = _mm256_cmpeq_epi64(diff, zero);
+      unsigned borrows = lookaheadCarries(_mm256_movemask_pd(_mm256_castsi256_pd(gen)),
+                                          _mm256_movemask_pd(_mm256_castsi256_pd(prop)), borrow);
+      __m256i sub = _mm256_and_si256(_mm256_srlv_epi64(_mm256_set1_epi64x(borrows), lanes), one);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(res + i), _mm256_sub_epi64(diff, sub));
     }
-    if (length == number.size()) {      // прибавление оставшихся цифр если кратчайшее - this
-      for (size_t ind = length; ind < num.number.size(); ind++) {
-        int64_t sum = buffer + num.number[ind];
-        number.push_back((sum >= kBase ? sum - kBase : sum));
-        buffer = (sum >= kBase ? 1 : 0);
-      }
-      if (buffer != 0) {
-        number.push_back(buffer);
-      }
-    } else {
-      size_t ind = length;
-      while (buffer == 1 && ind < number.size()) {
-        int64_t sum = buffer + number[ind];
-        number[ind] = (sum >= kBase ? sum - kBase : sum);
-        buffer = (sum >= kBase ? 1 : 0);
-        ind += 1;
-      }
-      if (buffer != 0) {
-        number.push_back(buffer);
-      }
+    for (; i < len; i++) {
+      DoubleLimb diff = static_cast<DoubleLimb>(a[i]) + kBase - b[i] - borrow;
+      res[i] = static_cast<Limb>(diff % kBase);
+      borrow = 1 - static_cast<unsigned>(diff / kBase);
     }
-    return *this;
+    return borrow;
   }
-  // умножение на цифру
-  BigInteger& operator*=(int64_t num) {
-    if (!number.empty() && num == kBase) {
-      number.insert(number.begin(), 0);
-      return *this;
+#endif
+
+  // res[0, len_a) = a + b, len_a >= len_b, возвращает перенос; res может совпадать с a
+  static Limb addLimbs(Limb* res, const Limb* a, size_t len_a, const Limb* b, size_t len_b) {
+    Limb carry = 0;
+    size_t i = 0;
+#ifdef BIGINTEGER_AVX2
+    if (sizeof(Limb) == 8 && len_b >= kSimdThreshold && simdAdditions() && hasAvx2()) {
+      carry = addLimbsAvx2(res, a, b, len_b);
+      i = len_b;
     }
-    if (num == 0) {
-      toNull();
-      return *this;
+#endif
+    for (; i < len_b; i++) {
+      DoubleLimb sum = static_cast<DoubleLimb>(a[i]) + b[i] + carry;
+      res[i] = static_cast<Limb>(sum % kBase);
+      carry = static_cast<Limb>(sum / kBase);
     }
-    if (signum == Sign::Null) {
-      return *this;
+    for (; i < len_a; i++) {
+      DoubleLimb sum = static_cast<DoubleLimb>(a[i]) + carry;
+      res[i] = static_cast<Limb>(sum % kBase);
+      carry = static_cast<Limb>(sum / kBase);
     }
-    if (num < 0) {
-      signum *= Sign::Negative;
+    return carry;
+  }
+
+  // res[0, len_a) = a - b, len_a >= len_b, возвращает заём; res может совпадать с a
+  static Limb subLimbs(Limb* res, const Limb* a, size_t len_a, const Limb* b, size_t len_b) {
+    Limb borrow = 0;
+    size_t i = 0;
+#ifdef BIGINTEGER_AVX2
+    if (sizeof(Limb) == 8 && len_b >= kSimdThreshold && simdAdditions() && hasAvx2()) {
+      borrow = subLimbsAvx2(res, a, b, len_b);
+      i = len_b;
     }
-    // перемножение ненулевых чисел с уже учтёнными знаками
-    int64_t buffer = 0;
-    for (unsigned i = 0; i < number.size(); i++) {
-      int64_t mult = buffer + num * number[i];
-      buffer = mult / kBase;
-      number[i] = (mult % kBase);
+#endif
+    for (; i < len_b; i++) {
+      DoubleLimb diff = static_cast<DoubleLimb>(a[i]) + kBase - b[i] - borrow;
+      res[i] = static_cast<Limb>(diff % kBase);
+      borrow = 1 - static_cast<Limb>(diff / kBase);
     }
-    if (buffer != 0) {
-      number.push_back(buffer);
+    for (; i < len_a; i++) {
+      DoubleLimb diff = static_cast<DoubleLimb>(a[i]) + kBase - borrow;
+      res[i] = static_cast<Limb>(diff % kBase);
+      borrow = 1 - static_cast<Limb>(diff / kBase);
     }
-    return *this;
+    return borrow;
   }
 
-  // умножение на число
-  BigInteger& operator*=(const BigInteger& num) {
-    if (num.signum == Sign::Null) {
-      toNull();
-      return *this;
-    }
-    if (signum == Sign::Null) {
-      return *this;
-    }
-    if (num.signum == Sign::Negative) {
-      signum *= Sign::Negative;
+  // a[0, len_a) += b для одной цифры b на месте, возвращает перенос; проход идёт, пока есть перенос
+  static Limb addLimb(Limb* a, size_t len_a, Limb b) {
+    DoubleLimb carry = b;
+    for (size_t i = 0; i < len_a && carry != 0; i++) {
+      carry += a[i];
+      a[i] = static_cast<Limb>(carry % kBase);
+      carry /= kBase;
     }
-    BigInteger copy = *this;
-    toNull();
-    for (int i = num.number.size() - 1; i >= 0; i--) {
-      *this *= kBase;
-      BigInteger mult = copy;
-      mult *= num.number[i];
-      *this += mult;
+    return static_cast<Limb>(carry);
+  }
+
+  // a[0, len_a) -= b для одной цифры b на месте, возвращает заём; проход идёт, пока есть заём
+  static Limb subLimb(Limb* a, size_t len_a, Limb b) {
+    Limb borrow = b;
+    for (size_t i = 0; i < len_a && borrow != 0; i++) {
+      DoubleLimb diff = static_cast<DoubleLimb>(a[i]) + kBase - borrow;
+      a[i] = static_cast<Limb>(diff % kBase);
+      borrow = 1 - static_cast<Limb>(diff / kBase);
     }
-    return *this;
+    return borrow;
   }
 
-  BigInteger& operator/=(BigInteger num) {
-    if (signum == Sign::Null) {
-      return *this;
+  // сравнение модулей a и b без ведущих нулей: -1, 0 или 1
+  static int cmpAbs(const Limb* a, size_t len_a, const Limb* b, size_t len_b) {
+    if (len_a != len_b) {
+      return len_a < len_b ? -1 : 1;
     }
-    BigInteger ans(0);
-    ans.number.clear();
-    ans.signum = signum * num.signum;
-    num.signum = Sign::Positive;
-    signum = Sign::Positive;
-    // деление столбиком
-    while (*this >= num) {
-      int len = num.number.size();
-      int64_t lef = 0;
-      int64_t rig = kBase;
-      // взятие куска первых цифр нужной длинны
-      BigInteger sub_b_int = subInt(len, number.size() - len);
-      if (sub_b_int < num) {
-        len += 1;
-        sub_b_int = subInt(len, number.size() - len);
-      }
-      // бинпоиск результата деления этого куска на делитель
-      while (lef != rig - 1) {
-        int64_t mid = (lef + rig) / 2;
-        (num * mid <= sub_b_int ? lef = mid : rig = mid);
-      }
-      ans.number.push_back(lef);
-      // вычитание из делимого (частное * делитель) с нужным сдвигом
-      int div_ans_degree_len = number.size() - len;
-      BigInteger div_value = (num * lef).upper(div_ans_degree_len);
-      *this -= div_value;
-      if (*this != 0) {
-        continue;
-      }
-      for (int i = 0; i < div_ans_degree_len; i++) {
-        ans.number.push_back(0);
+    for (size_t i = len_a; i-- > 0;) {
+      if (a[i] != b[i]) {
+        return a[i] < b[i] ? -1 : 1;
       }
-      break;
     }
-    std::reverse(ans.number.begin(), ans.number.end());
-    ans.clearNulls();
-    swap(ans);
-    return *this;
+    return 0;
   }
 
-  BigInteger& operator%=(const BigInteger& num) {
-    BigInteger copy = *this;
-    copy /= num;
-    copy *= num;
-    *this -= copy;
-    clearNulls();
-    return *this;
+  // a = |a| + |b| на месте; b может указывать на цифры самого a
+  static void addAbs(LimbVector& a, const Limb* b, size_t len_b) {
+    if (a.size() < len_b) {
+      a.resize(len_b, 0);
+    }
+    Limb carry = addLimbs(a.data(), a.data(), a.size(), b, len_b);
+    if (carry != 0) {
+      a.push_back(carry);
+    }
   }
 
-  BigInteger operator-() {
-    BigInteger copy = *this;
-    copy.signum *= Sign::Negative;
-    return copy;
+  // a = ||a| - |b|| на месте, возвращает true, если |b| > |a| (знак разности сменился);
+  // результат может содержать ведущие нули
+  static bool subAbs(LimbVector& a, const Limb* b, size_t len_b) {
+    int cmp = cmpAbs(a.data(), a.size(), b, len_b);
+    if (cmp == 0) {
+      a.clear();
+      return false;
+    }
+    if (cmp > 0) {
+      subLimbs(a.data(), a.data(), a.size(), b, len_b);
+      return false;
+    }
+    // |b| > |a|, значит b не совпадает с цифрами a: вычитаем в обратную сторону прямо в буфер a
+    size_t len_a = a.size();
+    a.resize(len_b, 0);
+    subLimbs(a.data(), b, len_b, a.data(), len_a);
+    return true;
   }
 
-  BigInteger& operator++() {
-    *this += 1;
-    return *this;
+  // res[0, len) = ka * a + kb * b для коэффициентов разных знаков, |ka|, |kb| < kLehmerBound;
+  // результат должен быть неотрицательным и меньше kBase^len, res может совпадать с a или b
+  static void combineLimbs(Limb* res, const Limb* a, const Limb* b, size_t len, int64_t ka, int64_t kb) {
+    if (ka < 0 || kb > 0) {
+      std::swap(a, b);
+      std::swap(ka, kb);
+    }
+    // теперь ka >= 0 >= kb: считаем ka * a - |kb| * b двумя переносами и одним заёмом
+    Limb mul_a = static_cast<Limb>(ka);
+    Limb mul_b = static_cast<Limb>(-kb);
+    DoubleLimb carry_a = 0;
+    DoubleLimb carry_b = 0;
+    Limb borrow = 0;
+    for (size_t i = 0; i < len; i++) {
+      DoubleLimb cur_a = static_cast<DoubleLimb>(a[i]) * mul_a + carry_a;
+      DoubleLimb cur_b = static_cast<DoubleLimb>(b[i]) * mul_b + carry_b;
+      carry_a = cur_a / kBase;
+      carry_b = cur_b / kBase;
+      DoubleLimb diff = cur_a % kBase + kBase - cur_b % kBase - borrow;
+      res[i] = static_cast<Limb>(diff % kBase);
+      borrow = 1 - static_cast<Limb>(diff / kBase);
+    }
   }
 
-  BigInteger operator++(int) {
-    BigInteger copy = *this;
-    *this += 1;
-    return copy;
+  // res[0, len_a) = a * b для одной цифры b, возвращает перенос; res может совпадать с a
+  static Limb mulLimb(Limb* res, const Limb* a, size_t len_a, Limb b) {
+    DoubleLimb carry = 0;
+    for (size_t i = 0; i < len_a; i++) {
+      DoubleLimb cur = static_cast<DoubleLimb>(a[i]) * b + carry;
+      res[i] = static_cast<Limb>(cur % kBase);
+      carry = cur / kBase;
+    }
+    return static_cast<Limb>(carry);
   }
 
-  BigInteger operator--() {
-    *this -= 1;
-    return *this;
+  // res[0, len_a) += a * b для одной цифры b, возвращает перенос
+  static Limb addMulLimb(Limb* res, const Limb* a, size_t len_a, Limb b) {
+    DoubleLimb carry = 0;
+    for (size_t i = 0; i < len_a; i++) {
+      DoubleLimb cur = static_cast<DoubleLimb>(a[i]) * b + res[i] + carry;
+      res[i] = static_cast<Limb>(cur % kBase);
+      carry = cur / kBase;
+    }
+    return static_cast<Limb>(carry);
   }
 
-  BigInteger operator--(int) {
-    BigInteger copy = *this;
-    *this -= 1;
-    return copy;
+  // редукция Монтгомери: t[0, 2 * len + 1) < m * kBase^len превращается в t * kBase^(-len) mod m,
+  // который оказывается в t[len, 2 * len); m_inv = -m^(-1) mod kBase
+  static void reduceMontgomery(Limb* t, const Limb* m, size_t len, Limb m_inv) {
+    for (size_t i = 0; i < len; i++) {
+      Limb factor = static_cast<Limb>(static_cast<DoubleLimb>(t[i]) * m_inv % kBase);
+      Limb carry = addMulLimb(t + i, m, len, factor);
+      for (size_t j = i + len; carry != 0; j++) {
+        DoubleLimb sum = static_cast<DoubleLimb>(t[j]) + carry;
+        t[j] = static_cast<Limb>(sum % kBase);
+        carry = static_cast<Limb>(sum / kBase);
+      }
+    }
+    if (t[2 * len] != 0 || cmpAbs(t + len, len, m, len) >= 0) {
+      subLimbs(t + len, t + len, len, m, len);
+      t[2 * len] = 0;
+    }
   }
 
-  BigInteger operator*(const BigInteger& num) const {
-    BigInteger ans = *this;
-    ans *= num;
-    return ans;
+  // res[0, len_a + len_b) = a * b столбиком, res не пересекается с a и b
+  static void mulSchoolbook(Limb* res, const Limb* a, size_t len_a, const Limb* b, size_t len_b) {
+    std::fill(res, res + len_a + len_b, 0);
+    for (size_t i = 0; i < len_a; i++) {
+      DoubleLimb carry = 0;
+      for (size_t j = 0; j < len_b; j++) {
+        DoubleLimb cur = static_cast<DoubleLimb>(a[i]) * b[j] + res[i + j] + carry;
+        res[i + j] = static_cast<Limb>(cur % kBase);
+        carry = cur / kBase;
+      }
+      res[i + len_b] = static_cast<Limb>(carry);
+    }
   }
 
-  BigInteger operator*(int64_t num) const {
-    BigInteger ans = *this;
-    ans *= num;
-    return ans;
+  // res[0, 2 * len) = a * a столбиком: каждое произведение a[i] * a[j], i < j, считается один раз
+  // и удваивается, потом добавляются квадраты a[i]^2
+  static void sqrSchoolbook(Limb* res, const Limb* a, size_t len) {
+    std::fill(res, res + 2 * len, 0);
+    for (size_t i = 0; i + 1 < len; i++) {
+      res[i + len] = addMulLimb(res + 2 * i + 1, a + i + 1, len - i - 1, a[i]);
+    }
+    addLimbs(res, res, 2 * len, res, 2 * len);
+    Limb carry = 0;
+    for (size_t i = 0; i < len; i++) {
+      DoubleLimb square = static_cast<DoubleLimb>(a[i]) * a[i];
+      DoubleLimb low = static_cast<DoubleLimb>(res[2 * i]) + square % kBase + carry;
+      res[2 * i] = static_cast<Limb>(low % kBase);
+      DoubleLimb high = static_cast<DoubleLimb>(res[2 * i + 1]) + square / kBase + low / kBase;
+      res[2 * i + 1] = static_cast<Limb>(high % kBase);
+      carry = static_cast<Limb>(high / kBase);
+    }
   }
 
-  BigInteger operator/(const BigInteger& num) const {
-    BigInteger ans = *this;
-    ans /= num;
-    return ans;
+  // сколько памяти нужно mulKaratsuba для умножения двух чисел длины len
+  static size_t karatsubaScratch(size_t len) {
+    if (len < kKaratsubaThreshold) {
+      return 0;
+    }
+    size_t half = len - len / 2;
+    return 4 * (half + 1) + karatsubaScratch(half + 1);
   }
 
-  BigInteger operator/(int64_t num) const {
-    BigInteger ans = *this;
-    ans /= num;
-    return ans;
+  // scratch для mulKaratsuba и sqrKaratsuba из буфера потока: они не зовут mulLimbs и не вызываются
+  // друг из друга, так что буфер не нужен двум вызовам сразу, а память под него выделяется один раз;
+  // буфер длиннее kScratchCacheLimbs заменяется меньшим при следующем запросе, который в кэш помещается
+  static Limb* karatsubaBuffer(size_t len) {
+    thread_local vector<Limb> buffer;
+    size_t need = karatsubaScratch(len);
+    if (buffer.size() < need || (buffer.size() > kScratchCacheLimbs && need <= kScratchCacheLimbs)) {
+      vector<Limb>(need).swap(buffer);
+    }
+    return buffer.data();
   }
 
-  BigInteger operator%(const BigInteger& num) const {
-    BigInteger ans = *this;
-    ans %= num;
-    return ans;
+  // res[0, 2 * len) = a * b, оба множителя длины len; scratch - karatsubaScratch(len) цифр
+  static void mulKaratsuba(Limb* res, const Limb* a, const Limb* b, size_t len, Limb* scratch) {
+    if (len < kKaratsubaThreshold) {
+      mulSchoolbook(res, a, len, b, len);
+      return;
+    }
+    // a = a1 * kBase^low + a0, b = b1 * kBase^low + b0
+    size_t low = len / 2;
+    size_t high = len - low;
+    Limb* sum_a = scratch;
+    Limb* sum_b = sum_a + high + 1;
+    Limb* middle = sum_b + high + 1;
+    Limb* next_scratch = middle + 2 * (high + 1);
+    sum_a[high] = addLimbs(sum_a, a + low, high, a, low);
+    sum_b[high] = addLimbs(sum_b, b + low, high, b, low);
+    // res = a1 * b1 * kBase^(2 * low) + a0 * b0
+    mulKaratsuba(res, a, b, low, next_scratch);
+    mulKaratsuba(res + 2 * low, a + low, b + low, high, next_scratch);
+    // middle = (a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1
+    mulKaratsuba(middle, sum_a, sum_b, high + 1, next_scratch);
+    subLimbs(middle, middle, 2 * (high + 1), res, 2 * low);
+    subLimbs(middle, middle, 2 * (high + 1), res + 2 * low, 2 * high);
+    // старшие цифры middle нулевые, поэтому прибавляем не больше 2 * len - low цифр
+    size_t middle_len = std::min(2 * (high + 1), 2 * len - low);
+    addLimbs(res + low, res + low, 2 * len - low, middle, middle_len);
   }
 
-  BigInteger operator%(int64_t num) const {
-    BigInteger ans = *this;
-    ans %= num;
-    return ans;
+  // res[0, 2 * len) = a * a; scratch - karatsubaScratch(len) цифр
+  static void sqrKaratsuba(Limb* res, const Limb* a, size_t len, Limb* scratch) {
+    if (len < kKaratsubaSquareThreshold) {
+      sqrSchoolbook(res, a, len);
+      return;
+    }
+    size_t low = len / 2;
+    size_t high = len - low;
+    Limb* sum = scratch;
+    Limb* middle = sum + high + 1;
+    Limb* next_scratch = middle + 2 * (high + 1);
+    sum[high] = addLimbs(sum, a + low, high, a, low);
+    sqrKaratsuba(res, a, low, next_scratch);
+    sqrKaratsuba(res + 2 * low, a + low, high, next_scratch);
+    // middle = (a0 + a1)^2 - a0^2 - a1^2
+    sqrKaratsuba(middle, sum, high + 1, next_scratch);
+    subLimbs(middle, middle, 2 * (high + 1), res, 2 * low);
+    subLimbs(middle, middle, 2 * (high + 1), res + 2 * low, 2 * high);
+    size_t middle_len = std::min(2 * (high + 1), 2 * len - low);
+    addLimbs(res + low, res + low, 2 * len - low, middle, middle_len);
   }
 
-  BigInteger operator+(const BigInteger& num) const {
-    BigInteger ans = *this;
-    ans += num;
-    return ans;
+  static uint32_t powModWord(uint64_t base, uint64_t exp, uint32_t mod) {
+    uint64_t ans = 1;
+    base %= mod;
+    while (exp > 0) {
+      if (exp & 1) {
+        ans = ans * base % mod;
+      }
+      base = base * base % mod;
+      exp >>= 1;
+    }
+    return static_cast<uint32_t>(ans);
   }
 
-  BigInteger operator+(int num) const {
-    BigInteger ans = *this;
-    ans += num;
-    return ans;
+  // task(begin, end) для threads кусков [0, size), куски кроме первого - в потоках WorkerPool
+  template <typename Task>
+  static void parallelFor(size_t threads, size_t size, Task task) {
+    threads = std::max<size_t>(1, std::min(threads, size));
+    if (threads == 1) {
+      task(0, size);
+      return;
+    }
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t pending = threads - 1;
+    for (size_t t = 1; t < threads; t++) {
+      size_t begin = size * t / threads;
+      size_t end = size * (t + 1) / threads;
+      WorkerPool::instance().submit([&task, &mutex, &finished, &pending, begin, end] {
+        task(begin, end);
+        // будим под замком: после pending == 0 вызывающий сразу уничтожает finished
+        std::lock_guard<std::mutex> lock(mutex);
+        pending -= 1;
+        finished.notify_one();
+      }, threads - 1);
+    }
+    task(0, size / threads);
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&pending] { return pending == 0; });
   }
 
-  BigInteger operator-(const BigInteger& num) const {
-    BigInteger ans = *this;
-    ans -= num;
-    return ans;
+  // этапы бабочек с длинами блоков 2, 4, ..., size над values[0, size) после перестановки
+  template <uint32_t kMod>
+  static void nttButterflies(uint32_t* values, size_t size, bool inverse) {
+    vector<uint32_t> roots(size / 2);
+    for (size_t len = 2; len <= size; len <<= 1) {
+      uint32_t step = nttRoot<kMod>(len, inverse);
+      size_t half = len / 2;
+      roots[0] = 1;
+      for (size_t j = 1; j < half; j++) {
+        roots[j] = static_cast<uint32_t>(static_cast<uint64_t>(roots[j - 1]) * step % kMod);
+      }
+      for (size_t i = 0; i < size; i += len) {
+        for (size_t j = 0; j < half; j++) {
+          nttButterfly<kMod>(values + i + j, half, roots[j]);
+        }
+      }
+    }
   }
 
-  BigInteger operator-(int num) const {
-    BigInteger ans = *this;
-    ans -= num;
-    return ans;
+  template <uint32_t kMod>
+  static uint32_t nttRoot(size_t len, bool inverse) {
+    uint32_t step = powModWord(3, (kMod - 1) / len, kMod);
+    return inverse ? powModWord(step, kMod - 2, kMod) : step;
   }
-};
-
-BigInteger operator*(int int1, const BigInteger& int2) {
-  BigInteger big_integer(int1);
-  return big_integer * int2;
-}
-
-BigInteger operator/(int int1, const BigInteger& int2) {
-  BigInteger big_integer(int1);
-  return big_integer / int2;
-}
-
-BigInteger operator+(int int1, const BigInteger& int2) {
-  BigInteger big_integer(int1);
-  return big_integer + int2;
-}
 
-BigInteger operator-(int int1, const BigInteger& int2) {
-  BigInteger big_integer(int1);
-  return big_integer - int2;
-}
-
-BigInteger operator%(int int1, const BigInteger& int2) {
-  BigInteger big_integer(int1);
-  return big_integer % int2;
-}
-
-bool operator<(const BigInteger& num1, const BigInteger& num2) {
-  if (num1.signum != num2.signum) {
-    return num1.signum < num2.signum;
-  }
-  if (num1.signum == Sign::Null) {
-    return false;
-  }
-  Sign ans = Sign::Null;
-  if (num1.number.size() != num2.number.size()) {
-    ans = (num1.number.size() < num2.number.size() ? Sign::Positive : Sign::Negative);
-    return (num1.signum == Sign::Negative ? ans == Sign::Negative : ans == Sign::Positive );
+  template <uint32_t kMod>
+  static void nttButterfly(uint32_t* value, size_t half, uint32_t root) {
+    uint32_t u = value[0];
+    uint32_t v = static_cast<uint32_t>(static_cast<uint64_t>(value[half]) * root % kMod);
+    value[0] = (u + v >= kMod ? u + v - kMod : u + v);
+    value[half] = (u >= v ? u - v : u + kMod - v);
   }
 
-  for (int i = num1.number.size() - 1; i >= 0; i--) {
-    if (num1.number[i] != num2.number[i]) {
-      ans = (num1.number[i] < num2.number[i] ? Sign::Positive : Sign::Negative);
-      break;
+  // преобразование на месте, размер values - степень двойки; в threads потоков младшие этапы
+  // идут независимо по кускам size / threads, а каждый старший этап делится по номеру бабочки
+  template <uint32_t kMod>
+  static void ntt(vector<uint32_t>& values, bool inverse, size_t threads = 1) {
+    size_t size = values.size();
+    size_t log_size = 0;
+    while ((size_t(1) << log_size) < size) {
+      log_size++;
+    }
+    size_t parts = 1;
+    while (2 * parts <= threads && 2 * parts <= size / 2) {
+      parts *= 2;
+    }
+    parallelFor(parts, size, [&values, size, log_size](size_t begin, size_t end) {
+      // j - перестановка индекса i - 1 в обратном порядке бит, дальше обновляется как в счётчике
+      size_t first = std::max<size_t>(begin, 1);
+      size_t j = 0;
+      for (size_t k = 0; k < log_size; k++) {
+        j |= (((first - 1) >> k) & 1) << (log_size - 1 - k);
+      }
+      for (size_t i = first; i < end; i++) {
+        size_t bit = size >> 1;
+        for (; j & bit; bit >>= 1) {
+          j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+          std::swap(values[i], values[j]);
+        }
+      }
+    });
+    size_t chunk = size / parts;
+    parallelFor(parts, parts, [&values, chunk, inverse](size_t begin, size_t end) {
+      for (size_t part = begin; part < end; part++) {
+        nttButterflies<kMod>(values.data() + part * chunk, chunk, inverse);
+      }
+    });
+    for (size_t len = 2 * chunk; len <= size; len <<= 1) {
+      uint32_t step = nttRoot<kMod>(len, inverse);
+      size_t half = len / 2;
+      parallelFor(parts, half, [&values, size, len, half, step](size_t begin, size_t end) {
+        uint32_t root = powModWord(step, begin, kMod);
+        for (size_t j = begin; j < end; j++) {
+          for (size_t i = 0; i < size; i += len) {
+            nttButterfly<kMod>(values.data() + i + j, half, root);
+          }
+          root = static_cast<uint32_t>(static_cast<uint64_t>(root) * step % kMod);
+        }
+      });
+    }
+    if (inverse) {
+      uint64_t size_inv = powModWord(size, kMod - 2, kMod);
+      parallelFor(parts, size, [&values, size_inv](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          values[i] = static_cast<uint32_t>(values[i] * size_inv % kMod);
+        }
+      });
     }
   }
-  return (num1.signum == Sign::Negative ? ans == Sign::Negative : ans == Sign::Positive);
-}
 
-bool operator>(const BigInteger& num1, const BigInteger& num2) {
-  return num2 < num1;
-}
+  // свёртка a и b (или a с собой, если b пусто) по модулю kMod, результат длины size
+  template <uint32_t kMod>
+  static vector<uint32_t> convolutionMod(const vector<uint32_t>& a, const vector<uint32_t>& b, size_t size,
+                                         size_t threads) {
+    vector<uint32_t> fa(size, 0);
+    for (size_t i = 0; i < a.size(); i++) {
+      fa[i] = a[i] % kMod;
+    }
+    ntt<kMod>(fa, false, threads);
+    vector<uint32_t> fb;
+    if (!b.empty()) {
+      fb.assign(size, 0);
+      for (size_t i = 0; i < b.size(); i++) {
+        fb[i] = b[i] % kMod;
+      }
+      ntt<kMod>(fb, false, threads);
+    }
+    const vector<uint32_t>& other = (b.empty() ? fa : fb);
+    parallelFor(threads, size, [&fa, &other](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        fa[i] = static_cast<uint32_t>(static_cast<uint64_t>(fa[i]) * other[i] % kMod);
+      }
+    });
+    ntt<kMod>(fa, true, threads);
+    return fa;
+  }
+
+  static vector<uint32_t> splitNttChunks(const Limb* a, size_t len) {
+    vector<uint32_t> chunks(len * kNttChunksPerLimb);
+    for (size_t i = 0; i < len; i++) {
+      Limb limb = a[i];
+      for (size_t j = 0; j < kNttChunksPerLimb; j++) {
+        chunks[i * kNttChunksPerLimb + j] = static_cast<uint32_t>(limb % kNttChunkBase);
+        limb /= kNttChunkBase;
+      }
+    }
+    return chunks;
+  }
+
+  // res[0, len_a + len_b) = a * b через свёртку по трём модулям и КТО; коэффициенты свёртки меньше
+  // min(len_a, len_b) * kNttChunksPerLimb * kNttChunkBase^2 <= 2^22 * 2^64 < kNttMod1 * kNttMod2 * kNttMod3
+  static void mulNtt(Limb* res, const Limb* a, size_t len_a, const Limb* b, size_t len_b, size_t threads = 1) {
+    vector<uint32_t> chunks_a = splitNttChunks(a, len_a);
+    vector<uint32_t> chunks_b;
+    if (a != b || len_a != len_b) {
+      chunks_b = splitNttChunks(b, len_b);
+    }
+    size_t conv_len = 2 * chunks_a.size() - 1;
+    if (!chunks_b.empty()) {
+      conv_len = chunks_a.size() + chunks_b.size() - 1;
+    }
+    size_t size = 1;
+    while (size < conv_len) {
+      size <<= 1;
+    }
+    vector<uint32_t> rem1 = convolutionMod<kNttMod1>(chunks_a, chunks_b, size, threads);
+    vector<uint32_t> rem2 = convolutionMod<kNttMod2>(chunks_a, chunks_b, size, threads);
+    vector<uint32_t> rem3 = convolutionMod<kNttMod3>(chunks_a, chunks_b, size, threads);
+    const uint64_t mod12 = static_cast<uint64_t>(kNttMod1) * kNttMod2;
+    const uint64_t inv1_mod2 = powModWord(kNttMod1, kNttMod2 - 2, kNttMod2);
+    const uint64_t inv12_mod3 = powModWord(mod12 % kNttMod3, kNttMod3 - 2, kNttMod3);
+    size_t len = len_a + len_b;
+    std::fill(res, res + len, 0);
+    // каждый поток собирает свои цифры [begin, end), перенос из старшей запоминается
+    // и потом прибавляется к следующим цифрам по порядку
+    size_t parts = std::max<size_t>(1, std::min(threads, len / kNttChunksPerLimb));
+    // mod12 * t3 < 2^87 не умещается в uint64_t, поэтому старшая половина mod12 даёт перенос сразу
+    // в следующий кусок: после каждого куска carry < 2^57
+    const uint64_t mod12_low = mod12 % kNttChunkBase;
+    const uint64_t mod12_high = mod12 / kNttChunkBase;
+    vector<uint64_t> carries(parts);
+    parallelFor(parts, parts, [&](size_t first_part, size_t last_part) {
+      for (size_t part = first_part; part < last_part; part++) {
+        uint64_t carry = 0;
+        Limb scale = 1;
+        size_t end = len * (part + 1) / parts * kNttChunksPerLimb;
+        for (size_t i = len * part / parts * kNttChunksPerLimb; i < end; i++) {
+          uint64_t high = 0;
+          if (i < conv_len) {
+            // Гарнер: x = r1 + p1 * t2 + p1 * p2 * t3
+            uint64_t r1 = rem1[i];
+            uint64_t t2 = (rem2[i] + kNttMod2 - r1 % kNttMod2) * inv1_mod2 % kNttMod2;
+            uint64_t low = r1 + kNttMod1 * t2;
+            uint64_t t3 = (rem3[i] + kNttMod3 - low % kNttMod3) * inv12_mod3 % kNttMod3;
+            carry += low + mod12_low * t3;
+            high = mod12_high * t3;
+          }
+          // куски собираются обратно в цифры: i-й кусок идёт в цифру i / kNttChunksPerLimb
+          scale = (i % kNttChunksPerLimb == 0 ? 1 : scale * kNttChunkBase);
+          res[i / kNttChunksPerLimb] += static_cast<Limb>(carry % kNttChunkBase) * scale;
+          carry = carry / kNttChunkBase + high;
+        }
+        carries[part] = carry;
+      }
+    });
+    for (size_t part = 0; part + 1 < parts; part++) {
+      DoubleLimb carry = carries[part];
+      for (size_t pos = len * (part + 1) / parts; carry != 0 && pos < len; pos++) {
+        carry += res[pos];
+        res[pos] = static_cast<Limb>(carry % kBase);
+        carry /= kBase;
+      }
+    }
+  }
+
+  // res[0, len_a + len_b) = a * b, res не пересекается с a и b; a == b считается как квадрат
+  static void mulLimbs(Limb* res, const Limb* a, size_t len_a, const Limb* b, size_t len_b) {
+    if (a == b && len_a == len_b) {
+      sqrLimbs(res, a, len_a);
+      return;
+    }
+    if (len_a < len_b) {
+      std::swap(a, b);
+      std::swap(len_a, len_b);
+    }
+    if (len_b < kKaratsubaThreshold) {
+      mulSchoolbook(res, a, len_a, b, len_b);
+      return;
+    }
+    bool use_ntt = (len_b >= kNttThreshold && 2 * len_b <= kNttMaxLength);
+    if (use_ntt && len_a + len_b <= kNttMaxLength) {
+      mulNtt(res, a, len_a, b, len_b, nttThreads(len_b));
+      return;
+    }
+    bool use_toom = (!use_ntt && len_b >= kToom3Threshold);
+    if (use_toom && len_a == len_b) {
+      mulToom3(res, a, len_a, b, len_b);
+      return;
+    }
+    if (!use_ntt && len_a == len_b) {
+      mulKaratsuba(res, a, b, len_b, karatsubaBuffer(len_b));
+      return;
+    }
+    // длинный множитель режем на куски: длины len_b для Карацубы и Тума-Кука или
+    // максимальной длины, которую ещё берёт NTT
+    size_t piece = (use_ntt ? kNttMaxLength - len_b : len_b);
+    vector<Limb> scratch(use_ntt || use_toom ? 0 : karatsubaScratch(len_b));
+    vector<Limb> part(piece + len_b);
+    std::fill(res, res + len_a + len_b, 0);
+    for (size_t pos = 0; pos < len_a; pos += piece) {
+      size_t len = std::min(piece, len_a - pos);
+      if (!use_ntt && !use_toom && len == len_b) {
+        mulKaratsuba(part.data(), a + pos, b, len_b, scratch.data());
+      } else {
+        mulLimbs(part.data(), a + pos, len, b, len_b);
+      }
+      addLimbs(res + pos, res + pos, len_a + len_b - pos, part.data(), len + len_b);
+    }
+  }
+
+  // res[0, 2 * len) = a * a, res не пересекается с a
+  static void sqrLimbs(Limb* res, const Limb* a, size_t len) {
+    if (len >= kNttThreshold && 2 * len <= kNttMaxLength) {
+      mulNtt(res, a, len, a, len, nttThreads(len));
+    } else if (len >= kToom3Threshold) {
+      // сюда же попадают квадраты длиннее, чем берёт одно NTT: Тум-Кук режет их на части
+      mulToom3(res, a, len, a, len);
+    } else {
+      sqrKaratsuba(res, a, len, karatsubaBuffer(len));
+    }
+  }
+
+  static BasicBigInteger fromLimbs(const Limb* limbs, size_t len) {
+    BasicBigInteger value;
+    value.number.assign(limbs, limbs + len);
+    value.signum = Sign::Positive;
+    value.clearNulls();
+    return value;
+  }
+
+  // res[0, len_a + len_b) = a * b по Туму-Куку: множители режутся на три части по part цифр,
+  // произведение восстанавливается по значениям в точках 0, 1, -1, -2 и бесконечности (схема Бодрато);
+  // при a == b все пять произведений - квадраты
+  static void mulToom3(Limb* res, const Limb* a, size_t len_a, const Limb* b, size_t len_b) {
+    bool square = (a == b && len_a == len_b);
+    size_t part = (std::max(len_a, len_b) + 2) / 3;
+    auto evaluate = [part](const Limb* x, size_t len, BasicBigInteger* values) {
+      BasicBigInteger parts[3];
+      for (size_t k = 0; k < 3; k++) {
+        size_t begin = std::min(k * part, len);
+        size_t end = (k == 2 ? len : std::min((k + 1) * part, len));
+        parts[k] = fromLimbs(x + begin, end - begin);
+      }
+      BasicBigInteger outer = parts[0] + parts[2];
+      values[0] = parts[0];
+      values[1] = outer + parts[1];
+      values[2] = outer - parts[1];
+      values[3] = values[2] + parts[2];
+      values[3] += values[3];
+      values[3] -= parts[0];
+      values[4] = parts[2];
+    };
+    BasicBigInteger values_a[5];
+    BasicBigInteger values_b[5];
+    evaluate(a, len_a, values_a);
+    if (!square) {
+      evaluate(b, len_b, values_b);
+    }
+    BasicBigInteger products[5];
+    for (size_t k = 0; k < 5; k++) {
+      products[k] = (square ? values_a[k].square() : values_a[k] * values_b[k]);
+    }
+    // коэффициенты произведения c0 + c1 x + ... + c4 x^4 из значений в точках
+    BasicBigInteger& c0 = products[0];
+    BasicBigInteger& c4 = products[4];
+    // деления ниже точные, поэтому достаточно поделить модуль на одну цифру
+    auto divide_exact = [](BasicBigInteger& value, Limb divisor) {
+      divModLimb(value.number.data(), value.number.data(), value.number.size(), divisor);
+      value.clearNulls();
+    };
+    BasicBigInteger c3 = products[3] - products[1];
+    divide_exact(c3, 3);
+    BasicBigInteger c1 = products[1] - products[2];
+    divide_exact(c1, 2);
+    BasicBigInteger c2 = products[2] - c0;
+    c3 -= c2;
+    c3.signum *= Sign::Negative;
+    divide_exact(c3, 2);
+    c3 += c4;
+    c3 += c4;
+    c2 += c1;
+    c2 -= c4;
+    c1 -= c3;
+    const BasicBigInteger* coefficients[5] = {&c0, &c1, &c2, &c3, &c4};
+    size_t len = len_a + len_b;
+    std::fill(res, res + len, 0);
+    for (size_t k = 0; k < 5; k++) {
+      const LimbVector& coefficient = coefficients[k]->number;
+      if (!coefficient.empty()) {
+        addLimbs(res + k * part, res + k * part, len - k * part, coefficient.data(), coefficient.size());
+      }
+    }
+  }
+
+
+  // quot[0, len_a) = a / b для одной цифры b, возвращает остаток; quot может совпадать с a
+  static Limb divModLimb(Limb* quot, const Limb* a, size_t len_a, Limb b) {
+    DoubleLimb rem = 0;
+    for (size_t i = len_a; i-- > 0;) {
+      DoubleLimb cur = rem * kBase + a[i];
+      quot[i] = static_cast<Limb>(cur / b);
+      rem = cur % b;
+    }
+    return static_cast<Limb>(rem);
+  }
+
+  // a mod b для одной цифры b, a не меняется
+  static Limb modLimb(const Limb* a, size_t len_a, Limb b) {
+    DoubleLimb rem = 0;
+    for (size_t i = len_a; i-- > 0;) {
+      rem = (rem * kBase + a[i]) % b;
+    }
+    return static_cast<Limb>(rem);
+  }
+
+  // деление столбиком по Кнуту (алгоритм D): quot[0, len_a - len_b + 1) = a / b, rem[0, len_b) = a % b,
+  // len_a >= len_b, старшая цифра b ненулевая
+  static void divModLimbs(Limb* quot, Limb* rem, const Limb* a, size_t len_a, const Limb* b, size_t len_b) {
+    if (len_b == 1) {
+      rem[0] = divModLimb(quot, a, len_a, b[0]);
+      return;
+    }
+    // нормализация: после умножения на norm старшая цифра делителя не меньше kBase / 2,
+    // и оценка цифры частного по двум старшим цифрам ошибается не больше чем на 2
+    Limb norm = static_cast<Limb>(kBase / (static_cast<DoubleLimb>(b[len_b - 1]) + 1));
+    LimbVector dividend(len_a + 1);
+    LimbVector divisor(len_b);
+    dividend[len_a] = mulLimb(dividend.data(), a, len_a, norm);
+    mulLimb(divisor.data(), b, len_b, norm);
+    Limb* u = dividend.data();
+    const Limb* v = divisor.data();
+    DoubleLimb v_top = v[len_b - 1];
+    DoubleLimb v_next = v[len_b - 2];
+    for (size_t j = len_a - len_b + 1; j-- > 0;) {
+      DoubleLimb top = static_cast<DoubleLimb>(u[j + len_b]) * kBase + u[j + len_b - 1];
+      DoubleLimb q_hat = top / v_top;
+      DoubleLimb r_hat = top % v_top;
+      while (q_hat >= static_cast<DoubleLimb>(kBase) ||
+             q_hat * v_next > r_hat * kBase + u[j + len_b - 2]) {
+        q_hat -= 1;
+        r_hat += v_top;
+        if (r_hat >= static_cast<DoubleLimb>(kBase)) {
+          break;
+        }
+      }
+      // u[j, j + len_b] -= q_hat * v
+      DoubleLimb carry = 0;
+      Limb borrow = 0;
+      for (size_t i = 0; i < len_b; i++) {
+        DoubleLimb prod = q_hat * v[i] + carry;
+        carry = prod / kBase;
+        DoubleLimb diff = static_cast<DoubleLimb>(u[j + i]) + kBase - prod % kBase - borrow;
+        u[j + i] = static_cast<Limb>(diff % kBase);
+        borrow = 1 - static_cast<Limb>(diff / kBase);
+      }
+      DoubleLimb diff = static_cast<DoubleLimb>(u[j + len_b]) + kBase - carry - borrow;
+      u[j + len_b] = static_cast<Limb>(diff % kBase);
+      if (diff < static_cast<DoubleLimb>(kBase)) {
+        // оценка оказалась на единицу больше - возвращаем делитель обратно
+        q_hat -= 1;
+        Limb back = addLimbs(u + j, u + j, len_b, v, len_b);
+        u[j + len_b] = static_cast<Limb>((u[j + len_b] + static_cast<DoubleLimb>(back)) % kBase);
+      }
+      quot[j] = static_cast<Limb>(q_hat);
+    }
+    divModLimb(rem, u, len_b, norm);
+  }
+
+  // quotient = dividend / divisor (с округлением к нулю), remainder = dividend - quotient * divisor
+  // за одно деление; quotient и remainder могут совпадать с dividend или divisor
+  static void divMod(const BasicBigInteger& dividend, const BasicBigInteger& divisor, BasicBigInteger& quotient,
+                     BasicBigInteger& remainder) {
+    size_t len_a = dividend.number.size();
+    size_t len_b = divisor.number.size();
+    if (dividend.signum == Sign::Null || len_a < len_b) {
+      remainder = dividend;
+      quotient.toNull();
+      return;
+    }
+    Sign quotient_sign = dividend.signum * divisor.signum;
+    Sign remainder_sign = dividend.signum;
+    if (len_b >= kNewtonDivisionThreshold && len_a - len_b >= kNewtonDivisionThreshold) {
+      BasicBigInteger dividend_abs = dividend;
+      BasicBigInteger divisor_abs = divisor;
+      dividend_abs.signum = Sign::Positive;
+      divisor_abs.signum = Sign::Positive;
+      BasicBigInteger inverse = reciprocal(divisor_abs);
+      divModReciprocal(dividend_abs, divisor_abs, inverse, quotient, remainder);
+    } else {
+      LimbVector quot(len_a - len_b + 1);
+      LimbVector rem(len_b);
+      divModLimbs(quot.data(), rem.data(), dividend.number.data(), len_a, divisor.number.data(), len_b);
+      quotient.number.swap(quot);
+      quotient.signum = Sign::Positive;
+      quotient.clearNulls();
+      remainder.number.swap(rem);
+      remainder.signum = Sign::Positive;
+      remainder.clearNulls();
+    }
+    if (quotient.signum != Sign::Null) {
+      quotient.signum = quotient_sign;
+    }
+    if (remainder.signum != Sign::Null) {
+      remainder.signum = remainder_sign;
+    }
+  }
+
+  // floor(kBase^(2 * len) / divisor) для положительного divisor из len цифр: обратное к половине
+  // старших цифр уточняется одним шагом Ньютона x += x * (kBase^(2 * len) - divisor * x) / kBase^(2 * len);
+  // при exact == false ответ может отличаться от точного на несколько единиц
+  static BasicBigInteger reciprocal(const BasicBigInteger& divisor, bool exact = true) {
+    size_t len = divisor.number.size();
+    BasicBigInteger power(1);
+    power.shiftLimbsLeft(2 * len);
+    if (len < kNewtonDivisionThreshold) {
+      return power / divisor;
+    }
+    // старших цифр берём с запасом, чтобы после шага Ньютона ошибка была в несколько единиц
+    size_t high_len = (len + 1) / 2 + 2;
+    size_t shift = len - high_len;
+    BasicBigInteger high = divisor;
+    high.shiftLimbsRight(shift);
+    BasicBigInteger high_inverse = reciprocal(high, false);
+    // error = kBase^(2 * len) - divisor * x для приближения x = high_inverse * kBase^shift
+    BasicBigInteger error = divisor * high_inverse;
+    error.shiftLimbsLeft(shift);
+    error -= power;
+    error.signum *= Sign::Negative;
+    // младшие len - 2 цифры error меняют поправку меньше чем на 1 / kBase, их отбрасываем
+    BasicBigInteger correction = error;
+    correction.shiftLimbsRight(len - 2);
+    correction *= high_inverse;
+    correction.shiftLimbsRight(high_len + 2);
+    BasicBigInteger approx = high_inverse;
+    approx.shiftLimbsLeft(shift);
+    approx += correction;
+    if (!exact) {
+      return approx;
+    }
+    error -= divisor * correction;
+    while (error.signum == Sign::Negative) {
+      approx -= 1;
+      error += divisor;
+    }
+    while (error >= divisor) {
+      approx += 1;
+      error -= divisor;
+    }
+    return approx;
+  }
+
+  // деление неотрицательных чисел через inverse = reciprocal(divisor): делимое режется на блоки по
+  // len цифр, и каждая цифра-блок частного оценивается снизу по старшим цифрам с ошибкой не больше 3
+  static void divModReciprocal(const BasicBigInteger& dividend, const BasicBigInteger& divisor,
+                               const BasicBigInteger& inverse, BasicBigInteger& quotient, BasicBigInteger& remainder) {
+    size_t len = divisor.number.size();
+    size_t len_a = dividend.number.size();
+    size_t blocks = (len_a + len - 1) / len;
+    LimbVector quot(blocks * len, 0);
+    BasicBigInteger rem;
+    for (size_t block = blocks; block-- > 0;) {
+      // cur = rem * kBase^len + очередной блок делимого, cur < divisor * kBase^len
+      BasicBigInteger cur;
+      size_t begin = block * len;
+      size_t end = std::min(begin + len, len_a);
+      cur.number.assign(dividend.number.begin() + begin, dividend.number.begin() + end);
+      cur.number.resize(len, 0);
+      cur.number.insert(cur.number.end(), rem.number.begin(), rem.number.end());
+      cur.signum = Sign::Positive;
+      cur.clearNulls();
+      BasicBigInteger part = cur;
+      part.shiftLimbsRight(len - 1);
+      part *= inverse;
+      part.shiftLimbsRight(len + 1);
+      rem = cur - part * divisor;
+      while (rem >= divisor) {
+        part += 1;
+        rem -= divisor;
+      }
+      std::copy(part.number.begin(), part.number.end(), quot.begin() + begin);
+    }
+    quotient.number.swap(quot);
+    quotient.signum = Sign::Positive;
+    quotient.clearNulls();
+    remainder.swap(rem);
+  }
+
+  // value в системе счисления kChunkBase (по kChunkDigits десятичных цифр), младшие первыми
+  static vector<uint32_t> toDecimalChunks(const BasicBigInteger& value);
+
+  // число из count цифр в системе счисления kChunkBase, младшие первыми
+  static BasicBigInteger fromDecimalChunks(const uint32_t* chunks, size_t count);
+
+  // произведение [first, last) деревом: перемножаются соседи, так что множители на каждом уровне
+  // близки по длине; итераторы произвольного доступа, верхние уровни дерева - в разных потоках
+  template <typename Iterator>
+  static BasicBigInteger product(Iterator first, Iterator last);
+
+  // n! через разложение на простые (prime swing): n! = ((n / 2)!)^2 * swing(n)
+  static BasicBigInteger factorial(uint64_t n);
+
+  // C(n, k) по показателям простых в разложении (теорема Лежандра); если k * log n меньше n
+  // (решето до n дороже самих множителей) или n больше kBinomialSieveLimit - делением
+  // произведения n - k + 1, ..., n на k!
+  static const uint64_t kBinomialSieveLimit = uint64_t(1) << 27;
+  static BasicBigInteger binomial(uint64_t n, uint64_t k);
+
+  string toString() const {
+    if (signum == Sign::Null || number.empty()) {
+      return "0";
+    }
+    vector<uint32_t> chunks = toDecimalChunks(*this);
+    uint32_t top = chunks.back();
+    size_t top_digits = 1;
+    for (uint32_t power = 10; power <= top; power *= 10) {
+      top_digits += 1;
+    }
+    size_t sign_len = (signum == Sign::Negative ? 1 : 0);
+    string string_value(sign_len + top_digits + kChunkDigits * (chunks.size() - 1), '0');
+    if (sign_len != 0) {
+      string_value[0] = '-';
+    }
+    // пишем с конца в заранее выделенную строку, все блоки кроме старшего дополнены нулями
+    size_t pos = string_value.size();
+    for (size_t i = 0; i + 1 < chunks.size(); i++) {
+      uint32_t chunk = chunks[i];
+      for (size_t digit = 0; digit < kChunkDigits; digit++) {
+        string_value[--pos] = static_cast<char>('0' + chunk % 10);
+        chunk /= 10;
+      }
+    }
+    for (size_t digit = 0; digit < top_digits; digit++) {
+      string_value[--pos] = static_cast<char>('0' + top % 10);
+      top /= 10;
+    }
+    return string_value;
+  }
+
+  BasicBigInteger() {
+    signum = Sign::Null;
+    number.clear();
+  }
+
+  BasicBigInteger(int input_number) {
+    signum = Sign::Positive;
+    if (input_number == 0) {
+      signum = Sign::Null;
+    }
+    if (input_number < 0) {
+      signum = Sign::Negative;
+    }
+    setMagnitude(input_number < 0 ? 0 - static_cast<uint64_t>(input_number) : input_number);
+  }
+
+  BasicBigInteger(const string& str) {
+    size_t begin = (!str.empty() && str[0] == '-' ? 1 : 0);
+    size_t end = begin;
+    while (end < str.size() && str[end] >= '0' && str[end] <= '9') {
+      end += 1;
+    }
+    // режем строку с конца на блоки по kChunkDigits цифр
+    vector<uint32_t> chunks((end - begin + kChunkDigits - 1) / kChunkDigits);
+    for (size_t i = 0; i < chunks.size(); i++) {
+      size_t chunk_end = end - kChunkDigits * i;
+      size_t chunk_begin = (chunk_end - begin > kChunkDigits ? chunk_end - kChunkDigits : begin);
+      uint32_t chunk = 0;
+      for (size_t j = chunk_begin; j < chunk_end; j++) {
+        chunk = chunk * 10 + (str[j] - '0');
+      }
+      chunks[i] = chunk;
+    }
+    BasicBigInteger value = fromDecimalChunks(chunks.data(), chunks.size());
+    swap(value);
+    if (signum != Sign::Null && begin == 1) {
+      signum = Sign::Negative;
+    }
+  }
+
+  explicit operator bool() {
+    return (signum != Sign::Null);
+  }
+
+  // цифры числа |value|, знак не меняется
+  void setMagnitude(uint64_t value) {
+    number.clear();
+    while (value > 0) {
+      number.push_back(static_cast<Limb>(value % kBase));
+      value = static_cast<uint64_t>(value / kBase);
+    }
+  }
+
+  void toNull() {
+    number.clear();
+    signum = Sign::Null;
+  }
+
+  void clearNulls() {
+    while (!number.empty() && number.back() == 0) {
+      number.pop_back();
+    }
+    if (number.empty()) {
+      signum = Sign::Null;
+    }
+  }
+
+  void swap(BasicBigInteger& integer) {
+    number.swap(integer.number);
+    std::swap(signum, integer.signum);
+  }
+
+  // умножение на kBase^count
+  void shiftLimbsLeft(size_t count) {
+    if (signum != Sign::Null) {
+      number.insert(number.begin(), count, 0);
+    }
+  }
+
+  // деление на kBase^count с округлением к нулю
+  void shiftLimbsRight(size_t count) {
+    if (count >= number.size()) {
+      toNull();
+      return;
+    }
+    number.erase(number.begin(), number.begin() + count);
+    clearNulls();
+  }
+
+  // *this += sign * |b|, без копий второго слагаемого
+  BasicBigInteger& addSigned(const Limb* b, size_t len_b, Sign sign) {
+    if (sign == Sign::Null) {
+      return *this;
+    }
+    if (signum == Sign::Null) {
+      number.assign(b, b + len_b);
+      signum = sign;
+      return *this;
+    }
+    if (signum == sign) {
+      addAbs(number, b, len_b);
+      return *this;
+    }
+    if (subAbs(number, b, len_b)) {
+      signum = sign;
+    }
+    clearNulls();
+    return *this;
+  }
+
+  BasicBigInteger& operator-=(const BasicBigInteger& num) {
+    return addSigned(num.number.data(), num.number.size(), num.signum * Sign::Negative);
+  }
+
+  BasicBigInteger& operator+=(const BasicBigInteger& num) {
+    return addSigned(num.number.data(), num.number.size(), num.signum);
+  }
+
+  // *this += sign * magnitude: модуль из одной цифры прибавляется на месте без временного BasicBigInteger
+  BasicBigInteger& addWord(uint64_t magnitude, Sign sign) {
+    if (magnitude == 0) {
+      return *this;
+    }
+    if (magnitude >= kBase) {
+      BasicBigInteger term;
+      term.setMagnitude(magnitude);
+      return addSigned(term.number.data(), term.number.size(), sign);
+    }
+    Limb value = static_cast<Limb>(magnitude);
+    if (signum == Sign::Null) {
+      number.assign(&value, &value + 1);
+      signum = sign;
+    } else if (signum == sign) {
+      Limb carry = addLimb(number.data(), number.size(), value);
+      if (carry != 0) {
+        number.push_back(carry);
+      }
+    } else if (number.size() == 1 && number[0] < value) {
+      number[0] = value - number[0];
+      signum = sign;
+    } else {
+      subLimb(number.data(), number.size(), value);
+      clearNulls();
+    }
+    return *this;
+  }
+
+  BasicBigInteger& operator+=(int64_t num) {
+    uint64_t magnitude = (num < 0 ? 0 - static_cast<uint64_t>(num) : num);
+    return addWord(magnitude, num < 0 ? Sign::Negative : Sign::Positive);
+  }
+
+  BasicBigInteger& operator-=(int64_t num) {
+    uint64_t magnitude = (num < 0 ? 0 - static_cast<uint64_t>(num) : num);
+    return addWord(magnitude, num < 0 ? Sign::Positive : Sign::Negative);
+  }
+  // умножение на цифру
+  BasicBigInteger& operator*=(int64_t num) {
+    if (num == 0) {
+      toNull();
+      return *this;
+    }
+    if (signum == Sign::Null) {
+      return *this;
+    }
+    if (num < 0) {
+      signum *= Sign::Negative;
+    }
+    uint64_t magnitude = (num < 0 ? 0 - static_cast<uint64_t>(num) : num);
+    if (magnitude >= kBase) {
+      BasicBigInteger factor;
+      factor.signum = Sign::Positive;
+      factor.setMagnitude(magnitude);
+      return *this *= factor;
+    }
+    Limb carry = mulLimb(number.data(), number.data(), number.size(), static_cast<Limb>(magnitude));
+    if (carry != 0) {
+      number.push_back(carry);
+    }
+    return *this;
+  }
+
+  // умножение на число
+  BasicBigInteger& operator*=(const BasicBigInteger& num) {
+    if (num.signum == Sign::Null) {
+      toNull();
+      return *this;
+    }
+    if (signum == Sign::Null) {
+      return *this;
+    }
+    if (num.signum == Sign::Negative) {
+      signum *= Sign::Negative;
+    }
+    // при x *= x указатели совпадают, и mulLimbs считает квадрат
+    LimbVector result(number.size() + num.number.size());
+    mulLimbs(result.data(), number.data(), number.size(), num.number.data(), num.number.size());
+    number.swap(result);
+    clearNulls();
+    return *this;
+  }
+
+  // *this += a * b и *this -= a * b без временного произведения
+  BasicBigInteger& addMul(const BasicBigInteger& a, const BasicBigInteger& b) {
+    return addProduct(a, b, Sign::Positive);
+  }
+
+  BasicBigInteger& subMul(const BasicBigInteger& a, const BasicBigInteger& b) {
+    return addProduct(a, b, Sign::Negative);
+  }
+
+  // буферы потока длиннее kScratchCacheLimbs цифр после вызова освобождаются: иначе одно умножение
+  // огромных чисел оставляет потоку столько же памяти до его завершения
+  static const size_t kScratchCacheLimbs = size_t(1) << 16;
+  template <typename Buffer>
+  static void releaseScratch(Buffer& buffer) {
+    if (buffer.capacity() > kScratchCacheLimbs) {
+      Buffer().swap(buffer);
+    }
+  }
+
+  // *this += sign * a * b: произведение считается в буфер потока, который живёт между вызовами,
+  // и сразу прибавляется к цифрам *this, так что цикл addMul по многим слагаемым не ходит в кучу
+  BasicBigInteger& addProduct(const BasicBigInteger& a, const BasicBigInteger& b, Sign sign) {
+    Sign product_sign = a.signum * b.signum * sign;
+    if (product_sign == Sign::Null) {
+      return *this;
+    }
+    thread_local LimbVector product;
+    size_t len = a.number.size() + b.number.size();
+    product.resize(len);
+    mulLimbs(product.data(), a.number.data(), a.number.size(), b.number.data(), b.number.size());
+    if (product[len - 1] == 0) {
+      len--;
+    }
+    addSigned(product.data(), len, product_sign);
+    releaseScratch(product);
+    return *this;
+  }
+
+  BasicBigInteger square() const {
+    BasicBigInteger result;
+    if (signum == Sign::Null) {
+      return result;
+    }
+    result.number.resize(2 * number.size());
+    sqrLimbs(result.number.data(), number.data(), number.size());
+    result.signum = Sign::Positive;
+    result.clearNulls();
+    return result;
+  }
+
+  // *this /= num с округлением к нулю за один проход по цифрам, возвращает остаток со знаком делимого
+  int64_t divModWord(int64_t num) {
+    assert(num != 0);
+    uint64_t magnitude = (num < 0 ? 0 - static_cast<uint64_t>(num) : num);
+    Sign dividend_sign = signum;
+    uint64_t rest = 0;
+    if (magnitude >= kBase) {
+      BasicBigInteger divisor;
+      divisor.setMagnitude(magnitude);
+      divisor.signum = Sign::Positive;
+      BasicBigInteger remainder;
+      divMod(*this, divisor, *this, remainder);
+      rest = remainder.magnitudeWord();
+    } else if (signum != Sign::Null) {
+      rest = divModLimb(number.data(), number.data(), number.size(), static_cast<Limb>(magnitude));
+      clearNulls();
+    }
+    if (num < 0) {
+      signum *= Sign::Negative;
+    }
+    return (dividend_sign == Sign::Negative ? -static_cast<int64_t>(rest) : static_cast<int64_t>(rest));
+  }
+
+  // *this % num со знаком делимого, число не меняется
+  int64_t modWord(int64_t num) const {
+    assert(num != 0);
+    uint64_t magnitude = (num < 0 ? 0 - static_cast<uint64_t>(num) : num);
+    if (magnitude >= kBase) {
+      BasicBigInteger quotient = *this;
+      return quotient.divModWord(num);
+    }
+    uint64_t rest = 0;
+    if (signum != Sign::Null) {
+      rest = modLimb(number.data(), number.size(), static_cast<Limb>(magnitude));
+    }
+    return (signum == Sign::Negative ? -static_cast<int64_t>(rest) : static_cast<int64_t>(rest));
+  }
+
+  // |*this| для чисел меньше 2^64
+  uint64_t magnitudeWord() const {
+    uint64_t value = 0;
+    for (size_t i = number.size(); i-- > 0;) {
+      value = static_cast<uint64_t>(value * kBase + number[i]);
+    }
+    return value;
+  }
+
+  // |*this| / kBase^(size - 1) по старшим kLeadingLimbs цифрам - не меньше 64 бит, *this != 0
+  static const size_t kLeadingLimbs = 1 + 64 / kLimbBits;
+  double leadingLimbs() const {
+    size_t len = number.size();
+    double result = 0;
+    double scale = 1;
+    for (size_t i = 0; i < kLeadingLimbs && i < len; i++) {
+      result += static_cast<double>(number[len - 1 - i]) * scale;
+      scale /= static_cast<double>(kBase);
+    }
+    return result;
+  }
+
+  BasicBigInteger& operator/=(int64_t num) {
+    divModWord(num);
+    return *this;
+  }
+
+  BasicBigInteger& operator%=(int64_t num) {
+    int64_t rest = modWord(num);
+    toNull();
+    return *this += rest;
+  }
+
+  BasicBigInteger& operator/=(const BasicBigInteger& num) {
+    BasicBigInteger remainder;
+    divMod(*this, num, *this, remainder);
+    return *this;
+  }
+
+  BasicBigInteger& operator%=(const BasicBigInteger& num) {
+    BasicBigInteger quotient;
+    divMod(*this, num, quotient, *this);
+    return *this;
+  }
+
+  BasicBigInteger operator-() const& {
+    BasicBigInteger copy = *this;
+    copy.signum *= Sign::Negative;
+    return copy;
+  }
+
+  BasicBigInteger operator-() && {
+    signum *= Sign::Negative;
+    return std::move(*this);
+  }
+
+  BasicBigInteger& operator++() {
+    *this += 1;
+    return *this;
+  }
+
+  BasicBigInteger operator++(int) {
+    BasicBigInteger copy = *this;
+    *this += 1;
+    return copy;
+  }
+
+  BasicBigInteger operator--() {
+    *this -= 1;
+    return *this;
+  }
+
+  BasicBigInteger operator--(int) {
+    BasicBigInteger copy = *this;
+    *this -= 1;
+    return copy;
+  }
+
+  // бинарные операции с временным операндом считают прямо в нём, и цепочка выражения не копирует
+  // промежуточные результаты; для двух временных забирается левый
+  // произведение сразу пишется в новый буфер, копия *this не нужна
+  BasicBigInteger operator*(const BasicBigInteger& num) const& {
+    if (&num == this) {
+      return square();
+    }
+    BasicBigInteger ans;
+    if (signum == Sign::Null || num.signum == Sign::Null) {
+      return ans;
+    }
+    ans.number.resize(number.size() + num.number.size());
+    mulLimbs(ans.number.data(), number.data(), number.size(), num.number.data(), num.number.size());
+    ans.signum = signum * num.signum;
+    ans.clearNulls();
+    return ans;
+  }
+
+  BasicBigInteger operator*(const BasicBigInteger& num) && {
+    *this *= num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator*(BasicBigInteger&& num) const& {
+    num *= *this;
+    return std::move(num);
+  }
+
+  BasicBigInteger operator*(BasicBigInteger&& num) && {
+    *this *= num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator*(int64_t num) const& {
+    BasicBigInteger ans = *this;
+    ans *= num;
+    return ans;
+  }
+
+  BasicBigInteger operator*(int64_t num) && {
+    *this *= num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator/(const BasicBigInteger& num) const& {
+    BasicBigInteger ans = *this;
+    ans /= num;
+    return ans;
+  }
+
+  BasicBigInteger operator/(const BasicBigInteger& num) && {
+    *this /= num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator/(int64_t num) const& {
+    BasicBigInteger ans = *this;
+    ans /= num;
+    return ans;
+  }
+
+  BasicBigInteger operator/(int64_t num) && {
+    *this /= num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator%(const BasicBigInteger& num) const& {
+    BasicBigInteger ans = *this;
+    ans %= num;
+    return ans;
+  }
+
+  BasicBigInteger operator%(const BasicBigInteger& num) && {
+    *this %= num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator%(int64_t num) const& {
+    BasicBigInteger ans;
+    ans += modWord(num);
+    return ans;
+  }
+
+  BasicBigInteger operator%(int64_t num) && {
+    *this %= num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator+(const BasicBigInteger& num) const& {
+    BasicBigInteger ans = *this;
+    ans += num;
+    return ans;
+  }
+
+  BasicBigInteger operator+(const BasicBigInteger& num) && {
+    *this += num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator+(BasicBigInteger&& num) const& {
+    num += *this;
+    return std::move(num);
+  }
+
+  BasicBigInteger operator+(BasicBigInteger&& num) && {
+    *this += num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator+(int64_t num) const& {
+    BasicBigInteger ans = *this;
+    ans += num;
+    return ans;
+  }
+
+  BasicBigInteger operator+(int64_t num) && {
+    *this += num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator-(const BasicBigInteger& num) const& {
+    BasicBigInteger ans = *this;
+    ans -= num;
+    return ans;
+  }
+
+  BasicBigInteger operator-(const BasicBigInteger& num) && {
+    *this -= num;
+    return std::move(*this);
+  }
+
+  // *this - num = -(num - *this)
+  BasicBigInteger operator-(BasicBigInteger&& num) const& {
+    num -= *this;
+    num.signum *= Sign::Negative;
+    return std::move(num);
+  }
+
+  BasicBigInteger operator-(BasicBigInteger&& num) && {
+    *this -= num;
+    return std::move(*this);
+  }
+
+  BasicBigInteger operator-(int64_t num) const& {
+    BasicBigInteger ans = *this;
+    ans -= num;
+    return ans;
+  }
+
+  BasicBigInteger operator-(int64_t num) && {
+    *this -= num;
+    return std::move(*this);
+  }
+
+  // сравнения - друзья внутри класса, чтобы в x < 1 число справа приводилось к BasicBigInteger
+  friend bool operator<(const BasicBigInteger& num1, const BasicBigInteger& num2) {
+    if (num1.signum != num2.signum) {
+      return num1.signum < num2.signum;
+    }
+    int cmp = cmpAbs(num1.number.data(), num1.number.size(), num2.number.data(), num2.number.size());
+    return (num1.signum == Sign::Negative ? cmp > 0 : cmp < 0);
+  }
+
+  friend bool operator>(const BasicBigInteger& num1, const BasicBigInteger& num2) {
+    return num2 < num1;
+  }
+
+  friend bool operator<=(const BasicBigInteger& num1, const BasicBigInteger& num2) {
+    return !(num2 < num1);
+  }
+
+  friend bool operator>=(const BasicBigInteger& num1, const BasicBigInteger& num2) {
+    return !(num1 < num2);
+  }
+
+  friend bool operator==(const BasicBigInteger& num1, const BasicBigInteger& num2) {
+    return num1.signum == num2.signum &&
+           cmpAbs(num1.number.data(), num1.number.size(), num2.number.data(), num2.number.size()) == 0;
+  }
+
+  friend bool operator!=(const BasicBigInteger& num1, const BasicBigInteger& num2) { return (!(num1 == num2)); }
+};
+
+using BigInteger = BasicBigInteger<BIGINTEGER_LIMB_POLICY>;
+
+// операторы с временными операндами и vector<BigInteger> полагаются на дешёвое перемещение
+static_assert(std::is_nothrow_move_constructible_v<BigInteger> && std::is_nothrow_move_assignable_v<BigInteger>);
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> operator*(int int1, const BasicBigInteger<LimbPolicy>& int2) {
+  BasicBigInteger<LimbPolicy> big_integer(int1);
+  return std::move(big_integer) * int2;
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> operator*(int int1, BasicBigInteger<LimbPolicy>&& int2) {
+  int2 *= int1;
+  return std::move(int2);
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> operator/(int int1, const BasicBigInteger<LimbPolicy>& int2) {
+  BasicBigInteger<LimbPolicy> big_integer(int1);
+  return std::move(big_integer) / int2;
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> operator+(int int1, const BasicBigInteger<LimbPolicy>& int2) {
+  BasicBigInteger<LimbPolicy> big_integer(int1);
+  return std::move(big_integer) + int2;
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> operator+(int int1, BasicBigInteger<LimbPolicy>&& int2) {
+  int2 += int1;
+  return std::move(int2);
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> operator-(int int1, const BasicBigInteger<LimbPolicy>& int2) {
+  BasicBigInteger<LimbPolicy> big_integer(int1);
+  return std::move(big_integer) - int2;
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> operator-(int int1, BasicBigInteger<LimbPolicy>&& int2) {
+  int2 -= int1;
+  int2.signum *= Sign::Negative;
+  return std::move(int2);
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> operator%(int int1, const BasicBigInteger<LimbPolicy>& int2) {
+  BasicBigInteger<LimbPolicy> big_integer(int1);
+  return std::move(big_integer) % int2;
+}
+
+BigInteger operator ""_bi(unsigned long long num) {
+  BigInteger ans;
+  ans.setMagnitude(num);
+  ans.signum = (num == 0 ? Sign::Null : Sign::Positive);
+  return ans;
+}
+
+template <typename LimbPolicy>
+istream& operator>>(istream& input, BasicBigInteger<LimbPolicy>& big_integer) {
+  string str;
+  input >> str;
+  big_integer = str;
+  return input;
+}
+
+template <typename LimbPolicy>
+ostream& operator<<(ostream& output, const BasicBigInteger<LimbPolicy>& big_integer) {
+  output << big_integer.toString();
+  return output;
+}
+
+// бинарный алгоритм Евклида для чисел до 2^64
+uint64_t binaryGcd(uint64_t a, uint64_t b) {
+  if (a == 0 || b == 0) {
+    return a | b;
+  }
+  int shift = __builtin_ctzll(a | b);
+  a >>= __builtin_ctzll(a);
+  while (b != 0) {
+    b >>= __builtin_ctzll(b);
+    if (a > b) {
+      std::swap(a, b);
+    }
+    b -= a;
+  }
+  return a << shift;
+}
+
+// шаг Лемера для a >= b > 0: по старшим цифрам находит матрицу (m[0][0] m[0][1]; m[1][0] m[1][1]),
+// переводящую (a, b) в пару соседних остатков алгоритма Евклида (Кнут, т. 2, 4.5.2, алгоритм L);
+// false, если по старшим цифрам нельзя сделать ни одного шага
+template <typename LimbPolicy>
+bool lehmerMatrix(const BasicBigInteger<LimbPolicy>& a, const BasicBigInteger<LimbPolicy>& b, int64_t matrix[2][2]) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  size_t len = a.number.size();
+  auto digit = [len](const Integer& value, size_t shift) -> typename Integer::DoubleLimb {
+    size_t pos = len - 1 - shift;
+    return pos < value.number.size() ? value.number[pos] : 0;
+  };
+  typename Integer::DoubleLimb top_a = digit(a, 0);
+  typename Integer::DoubleLimb top_b = digit(b, 0);
+  if (len >= 2) {
+    top_a = top_a * Integer::kBase + digit(a, 1);
+    top_b = top_b * Integer::kBase + digit(b, 1);
+  }
+  typename Integer::DoubleLimb scale = top_a / Integer::kLehmerBound + 1;
+  int64_t x = static_cast<int64_t>(top_a / scale);
+  int64_t y = static_cast<int64_t>(top_b / scale);
+  int64_t ma = 1;
+  int64_t mb = 0;
+  int64_t mc = 0;
+  int64_t md = 1;
+  while (y + mc != 0 && y + md != 0) {
+    int64_t quot = (x + ma) / (y + mc);
+    if (quot != (x + mb) / (y + md)) {
+      break;
+    }
+    int64_t tmp = ma - quot * mc;
+    ma = mc;
+    mc = tmp;
+    tmp = mb - quot * md;
+    mb = md;
+    md = tmp;
+    tmp = x - quot * y;
+    x = y;
+    y = tmp;
+  }
+  matrix[0][0] = ma;
+  matrix[0][1] = mb;
+  matrix[1][0] = mc;
+  matrix[1][1] = md;
+  return mb != 0;
+}
+
+// (a, b) = (m[0][0] * a + m[0][1] * b, m[1][0] * a + m[1][1] * b) для a, b >= 0, scratch - буфер под результат
+template <typename LimbPolicy>
+void applyLehmerMatrix(BasicBigInteger<LimbPolicy>& a, BasicBigInteger<LimbPolicy>& b, const int64_t matrix[2][2],
+                       BasicBigInteger<LimbPolicy>& scratch) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  size_t len = a.number.size();
+  b.number.resize(len, 0);
+  scratch.number.resize(len);
+  Integer::combineLimbs(scratch.number.data(), a.number.data(), b.number.data(), len, matrix[0][0], matrix[0][1]);
+  Integer::combineLimbs(b.number.data(), a.number.data(), b.number.data(), len, matrix[1][0], matrix[1][1]);
+  a.number.swap(scratch.number);
+  a.signum = Sign::Positive;
+  b.signum = Sign::Positive;
+  a.clearNulls();
+  b.clearNulls();
+}
+
+// алгоритм Лемера: почти все шаги Евклида делаются над приближениями старших цифр,
+// полное деление - только когда длины сильно разошлись; последняя цифра - бинарным алгоритмом
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> gcd(BasicBigInteger<LimbPolicy> int1, BasicBigInteger<LimbPolicy> int2) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  if (int1 == 0) {
+    return int2;
+  }
+  if (int2 == 0) {
+    return int1;
+  }
+  int1.signum = Sign::Positive;
+  int2.signum = Sign::Positive;
+  if (int1 < int2) { int1.swap(int2); }
+  Integer scratch;
+  int64_t matrix[2][2];
+  while (int2.number.size() > 1) {
+    if (lehmerMatrix(int1, int2, matrix)) {
+      applyLehmerMatrix(int1, int2, matrix, scratch);
+    } else {
+      int1 %= int2;
+      int1.swap(int2);
+    }
+  }
+  if (int2.signum == Sign::Null) {
+    return int1;
+  }
+  typename Integer::Limb rest = Integer::modLimb(int1.number.data(), int1.number.size(), int2.number[0]);
+  int2.number[0] = static_cast<typename Integer::Limb>(binaryGcd(int2.number[0], rest));
+  return int2;
+}
+
+// g = gcd(a, b) >= 0 и коэффициенты Безу: a * x + b * y = g
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> gcdExtended(const BasicBigInteger<LimbPolicy>& a, const BasicBigInteger<LimbPolicy>& b,
+                                        BasicBigInteger<LimbPolicy>& x, BasicBigInteger<LimbPolicy>& y) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  // инвариант: rem0 = coef0 * |a| (mod |b|), rem1 = coef1 * |a| (mod |b|)
+  Integer rem0 = a;
+  Integer rem1 = b;
+  if (rem0.signum != Sign::Null) {
+    rem0.signum = Sign::Positive;
+  }
+  if (rem1.signum != Sign::Null) {
+    rem1.signum = Sign::Positive;
+  }
+  Integer coef0(1);
+  Integer coef1(0);
+  if (rem0 < rem1) {
+    rem0.swap(rem1);
+    coef0.swap(coef1);
+  }
+  Integer scratch;
+  Integer quot;
+  Integer rem;
+  int64_t matrix[2][2];
+  while (rem1.signum != Sign::Null) {
+    if (lehmerMatrix(rem0, rem1, matrix)) {
+      applyLehmerMatrix(rem0, rem1, matrix, scratch);
+      Integer next = coef0 * matrix[1][0] + coef1 * matrix[1][1];
+      coef0 = coef0 * matrix[0][0] + coef1 * matrix[0][1];
+      coef1.swap(next);
+    } else {
+      Integer::divMod(rem0, rem1, quot, rem);
+      rem0.swap(rem1);
+      rem1.swap(rem);
+      coef0 -= quot * coef1;
+      coef0.swap(coef1);
+    }
+  }
+  x = coef0;
+  if (a.signum == Sign::Negative) {
+    x.signum *= Sign::Negative;
+  }
+  if (b.signum == Sign::Null) {
+    y = 0;
+  } else {
+    // a * x = g (mod b), y находится точным делением
+    y = rem0 - a * x;
+    y /= b;
+  }
+  return rem0;
+}
+
+// делитель с заранее посчитанным обратным по Ньютону, чтобы много раз делить на одно и то же число
+template <typename LimbPolicy>
+struct PrecomputedDivisor {
+  using Integer = BasicBigInteger<LimbPolicy>;
+
+  Integer divisor;
+  Integer inverse;
+  Sign signum;
+
+  explicit PrecomputedDivisor(const Integer& value) : divisor(value), signum(value.signum) {
+    if (divisor.signum != Sign::Null) {
+      divisor.signum = Sign::Positive;
+    }
+    inverse = Integer::reciprocal(divisor);
+  }
+
+  void divMod(const Integer& dividend, Integer& quotient, Integer& remainder) const {
+    size_t len_a = dividend.number.size();
+    size_t len_b = divisor.number.size();
+    if (len_b < Integer::kNewtonDivisionThreshold || len_a < len_b + Integer::kNewtonDivisionThreshold) {
+      Integer::divMod(dividend, divisor, quotient, remainder);
+      if (quotient.signum != Sign::Null) {
+        quotient.signum *= signum;
+      }
+      return;
+    }
+    Sign dividend_sign = dividend.signum;
+    Integer dividend_abs = dividend;
+    dividend_abs.signum = Sign::Positive;
+    Integer::divModReciprocal(dividend_abs, divisor, inverse, quotient, remainder);
+    if (quotient.signum != Sign::Null) {
+      quotient.signum = dividend_sign * signum;
+    }
+    if (remainder.signum != Sign::Null) {
+      remainder.signum = dividend_sign;
+    }
+  }
+
+  Integer quotient(const Integer& dividend) const {
+    Integer quot;
+    Integer rem;
+    divMod(dividend, quot, rem);
+    return quot;
+  }
+
+  Integer remainder(const Integer& dividend) const {
+    Integer quot;
+    Integer rem;
+    divMod(dividend, quot, rem);
+    return rem;
+  }
+};
+
+// value < kChunkBase^(2^level) пишется в out[0, 2^level), powers[k] = kChunkBase^(2^k)
+template <typename LimbPolicy>
+void writeDecimalChunks(const BasicBigInteger<LimbPolicy>& value, const vector<PrecomputedDivisor<LimbPolicy>>& powers,
+                        size_t level, uint32_t* out) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  if (value.signum == Sign::Null) {
+    return;
+  }
+  if (level == 0 || value.number.size() <= Integer::kConversionThreshold) {
+    vector<typename Integer::Limb> rest(value.number.begin(), value.number.end());
+    for (size_t i = 0; !rest.empty(); i++) {
+      out[i] = Integer::divModLimb(rest.data(), rest.data(), rest.size(), Integer::kChunkBase);
+      while (!rest.empty() && rest.back() == 0) {
+        rest.pop_back();
+      }
+    }
+    return;
+  }
+  Integer high;
+  Integer low;
+  powers[level - 1].divMod(value, high, low);
+  writeDecimalChunks(low, powers, level - 1, out);
+  writeDecimalChunks(high, powers, level - 1, out + (size_t(1) << (level - 1)));
+}
+
+// число из chunks[0, count), count <= 2^level, powers[k] = kChunkBase^(2^k)
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> readDecimalChunks(const uint32_t* chunks, size_t count,
+                                              const vector<BasicBigInteger<LimbPolicy>>& powers, size_t level) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  if (count <= Integer::kConversionThreshold) {
+    Integer value;
+    value.signum = Sign::Positive;
+    for (size_t i = count; i-- > 0;) {
+      typename Integer::Limb carry = Integer::mulLimb(value.number.data(), value.number.data(), value.number.size(),
+                                                      Integer::kChunkBase);
+      value.number.push_back(carry);
+      typename Integer::Limb chunk = chunks[i];
+      Integer::addLimbs(value.number.data(), value.number.data(), value.number.size(), &chunk, 1);
+    }
+    value.clearNulls();
+    return value;
+  }
+  size_t half = size_t(1) << (level - 1);
+  if (count <= half) {
+    return readDecimalChunks(chunks, count, powers, level - 1);
+  }
+  Integer value = readDecimalChunks(chunks + half, count - half, powers, level - 1);
+  value *= powers[level - 1];
+  value += readDecimalChunks(chunks, half, powers, level - 1);
+  return value;
+}
+
+template <typename LimbPolicy>
+vector<uint32_t> BasicBigInteger<LimbPolicy>::toDecimalChunks(const BasicBigInteger& value) {
+  BasicBigInteger value_abs = value;
+  value_abs.signum = Sign::Positive;
+  // оценка сверху на число блоков по kChunkDigits цифр и степени kChunkBase^(2^k) под неё
+  double limb_digits = std::log10(static_cast<double>(kBase));
+  size_t max_chunks = static_cast<size_t>(value.number.size() * limb_digits / kChunkDigits) + 2;
+  vector<PrecomputedDivisor<LimbPolicy>> powers;
+  BasicBigInteger power(static_cast<int>(kChunkBase));
+  while ((size_t(1) << powers.size()) < max_chunks) {
+    if (!powers.empty()) {
+      power *= power;
+    }
+    powers.emplace_back(power);
+  }
+  vector<uint32_t> chunks(size_t(1) << powers.size(), 0);
+  writeDecimalChunks(value_abs, powers, powers.size(), chunks.data());
+  while (chunks.size() > 1 && chunks.back() == 0) {
+    chunks.pop_back();
+  }
+  return chunks;
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> BasicBigInteger<LimbPolicy>::fromDecimalChunks(const uint32_t* chunks, size_t count) {
+  vector<BasicBigInteger> powers;
+  while ((size_t(1) << powers.size()) < count) {
+    powers.push_back(powers.empty() ? BasicBigInteger(static_cast<int>(kChunkBase)) : powers.back() * powers.back());
+  }
+  return readDecimalChunks(chunks, count, powers, powers.size());
+}
+
+// произведение values[first, last), threads - сколько потоков можно занять; поддеревья короче
+// parallelThreshold() цифр считаются в одном потоке, и умножения в них не запускают потоков NTT
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> productTree(const vector<BasicBigInteger<LimbPolicy>>& values, size_t first, size_t last,
+                                        size_t threads) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  if (last - first == 0) {
+    return 1;
+  }
+  if (last - first == 1) {
+    return values[first];
+  }
+  if (threads > 1) {
+    size_t total = 0;
+    for (size_t i = first; i < last; i++) {
+      total += values[i].number.size();
+    }
+    if (total < Integer::parallelThreshold()) {
+      threads = 1;
+    }
+  }
+  size_t middle = first + (last - first) / 2;
+  Integer left;
+  Integer right;
+  if (threads > 1) {
+    std::thread worker([&values, &left, first, middle, threads] {
+      left = productTree(values, first, middle, threads / 2);
+    });
+    right = productTree(values, middle, last, threads - threads / 2);
+    worker.join();
+  } else {
+    left = productTree(values, first, middle, 1);
+    right = productTree(values, middle, last, 1);
+  }
+  // умножение в узле занимает только потоки своего поддерева
+  size_t& budget = Integer::threadBudget();
+  size_t saved = budget;
+  budget = threads;
+  left *= right;
+  budget = saved;
+  return left;
+}
+
+// произведение по дереву на multiplicationThreads() потоках, но не больше, чем разрешено вызывающему
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> productTree(const vector<BasicBigInteger<LimbPolicy>>& values) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  size_t threads = Integer::multiplicationThreads();
+  if (Integer::threadBudget() < threads) {
+    threads = Integer::threadBudget();
+  }
+  return productTree(values, 0, values.size(), threads);
+}
+
+template <typename LimbPolicy>
+template <typename Iterator>
+BasicBigInteger<LimbPolicy> BasicBigInteger<LimbPolicy>::product(Iterator first, Iterator last) {
+  vector<BasicBigInteger> values;
+  values.reserve(last - first);
+  for (; first != last; ++first) {
+    values.emplace_back(*first);
+  }
+  return productTree(values);
+}
+
+// произведение степеней простых primes[i]^exponents[i]: маленькие множители сначала
+// упаковываются в цифры, чтобы листья дерева не были короче одной цифры
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> productOfPowers(const vector<uint32_t>& primes, const vector<uint32_t>& exponents) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  vector<Integer> factors;
+  typename Integer::Limb limb = 1;
+  for (size_t i = 0; i < primes.size(); i++) {
+    for (uint32_t e = 0; e < exponents[i]; e++) {
+      if (static_cast<typename Integer::DoubleLimb>(limb) * primes[i] >= Integer::kBase) {
+        factors.push_back(Integer::fromLimbs(&limb, 1));
+        limb = 1;
+      }
+      limb *= primes[i];
+    }
+  }
+  factors.push_back(Integer::fromLimbs(&limb, 1));
+  return productTree(factors);
+}
+
+// простые до n включительно решетом Эратосфена
+vector<uint32_t> primesUpTo(uint64_t n) {
+  vector<uint32_t> primes;
+  vector<bool> composite(n + 1, false);
+  for (uint64_t p = 2; p <= n; p++) {
+    if (composite[p]) {
+      continue;
+    }
+    primes.push_back(static_cast<uint32_t>(p));
+    for (uint64_t multiple = p * p; multiple <= n; multiple += p) {
+      composite[multiple] = true;
+    }
+  }
+  return primes;
+}
+
+// n! по уже найденным простым до n
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> primeSwingFactorial(uint64_t n, const vector<uint32_t>& primes) {
+  if (n < 2) {
+    return 1;
+  }
+  // swing(n) = n! / ((n / 2)!)^2, показатель p в нём - число нечётных floor(n / p^i)
+  vector<uint32_t> swing_primes;
+  vector<uint32_t> exponents;
+  for (uint32_t p : primes) {
+    if (p > n) {
+      break;
+    }
+    uint32_t exponent = 0;
+    for (uint64_t rest = n / p; rest > 0; rest /= p) {
+      exponent += rest & 1;
+    }
+    if (exponent > 0) {
+      swing_primes.push_back(p);
+      exponents.push_back(exponent);
+    }
+  }
+  BasicBigInteger<LimbPolicy> result = primeSwingFactorial<LimbPolicy>(n / 2, primes).square();
+  result *= productOfPowers<LimbPolicy>(swing_primes, exponents);
+  return result;
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> BasicBigInteger<LimbPolicy>::factorial(uint64_t n) {
+  return primeSwingFactorial<LimbPolicy>(n, primesUpTo(n));
+}
+
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> BasicBigInteger<LimbPolicy>::binomial(uint64_t n, uint64_t k) {
+  if (k > n) {
+    return 0;
+  }
+  k = std::min(k, n - k);
+  if (n > kBinomialSieveLimit || k * std::bit_width(n) < n) {
+    // решето до n слишком велико или дороже произведения k множителей: n * (n - 1) * ... * (n - k + 1) / k!
+    vector<BasicBigInteger> factors;
+    factors.reserve(k);
+    for (uint64_t i = n - k + 1; i <= n; i++) {
+      factors.emplace_back();
+      factors.back().setMagnitude(i);
+      factors.back().signum = Sign::Positive;
+    }
+    return productTree(factors) / factorial(k);
+  }
+  vector<uint32_t> primes = primesUpTo(n);
+  vector<uint32_t> exponents(primes.size());
+  for (size_t i = 0; i < primes.size(); i++) {
+    // показатель p в C(n, k) - число переносов при сложении k и n - k в системе счисления p
+    for (uint64_t power = primes[i]; power <= n; power *= primes[i]) {
+      exponents[i] += n / power - k / power - (n - k) / power;
+      if (power > n / primes[i]) {
+        break;
+      }
+    }
+  }
+  return productOfPowers<LimbPolicy>(primes, exponents);
+}
+
+// двоичные цифры неотрицательного value, младшие первыми
+template <typename LimbPolicy>
+vector<uint8_t> binaryDigits(const BasicBigInteger<LimbPolicy>& value) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  const size_t chunk_bits = 16;
+  vector<uint8_t> bits;
+  vector<typename Integer::Limb> rest(value.number.begin(), value.number.end());
+  while (!rest.empty()) {
+    typename Integer::Limb chunk = Integer::divModLimb(rest.data(), rest.data(), rest.size(),
+                                                       typename Integer::Limb(1) << chunk_bits);
+    for (size_t i = 0; i < chunk_bits; i++) {
+      bits.push_back((chunk >> i) & 1);
+    }
+    while (!rest.empty() && rest.back() == 0) {
+      rest.pop_back();
+    }
+  }
+  while (!bits.empty() && bits.back() == 0) {
+    bits.pop_back();
+  }
+  return bits;
+}
+
+// base^exp скользящим окном; multiply - умножение по модулю, one - единица в том же представлении
+template <typename LimbPolicy, typename Multiply>
+BasicBigInteger<LimbPolicy> powSlidingWindow(const BasicBigInteger<LimbPolicy>& base, const BasicBigInteger<LimbPolicy>& exp,
+                                             const BasicBigInteger<LimbPolicy>& one, Multiply multiply) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  vector<uint8_t> bits = binaryDigits(exp);
+  if (bits.empty()) {
+    return one;
+  }
+  // окно растёт с длиной показателя: 2^(window - 1) предпосчитанных степеней против числа умножений
+  size_t window = 1;
+  while (window < 6 && bits.size() > (size_t(3) << (2 * window))) {
+    window++;
+  }
+  // odd_powers[k] = base^(2k + 1)
+  vector<Integer> odd_powers(size_t(1) << (window - 1));
+  odd_powers[0] = base;
+  if (odd_powers.size() > 1) {
+    Integer square = multiply(base, base);
+    for (size_t k = 1; k < odd_powers.size(); k++) {
+      odd_powers[k] = multiply(odd_powers[k - 1], square);
+    }
+  }
+  Integer result = one;
+  bool is_one = true;
+  size_t pos = bits.size();
+  while (pos > 0) {
+    if (bits[pos - 1] == 0) {
+      if (!is_one) {
+        result = multiply(result, result);
+      }
+      pos--;
+      continue;
+    }
+    // самое длинное окно bits[low, pos) не длиннее window, которое кончается единицей
+    size_t low = (pos >= window ? pos - window : 0);
+    while (bits[low] == 0) {
+      low++;
+    }
+    size_t value = 0;
+    for (size_t i = pos; i-- > low;) {
+      value = 2 * value + bits[i];
+    }
+    if (is_one) {
+      result = odd_powers[value / 2];
+      is_one = false;
+    } else {
+      for (size_t i = low; i < pos; i++) {
+        result = multiply(result, result);
+      }
+      result = multiply(result, odd_powers[value / 2]);
+    }
+    pos = low;
+  }
+  return result;
+}
+
+// арифметика по фиксированному модулю, взаимно простому с kBase, в форме Монтгомери:
+// число x хранится как x * R mod modulus, R = kBase^len, и умножение обходится без деления
+template <typename LimbPolicy>
+struct MontgomeryContext {
+  using Integer = BasicBigInteger<LimbPolicy>;
+
+  Integer modulus;
+  // R^2 mod modulus, чтобы переводить числа в форму Монтгомери
+  Integer r_squared;
+  // -modulus^(-1) mod kBase
+  typename Integer::Limb inverse;
+
+  explicit MontgomeryContext(const Integer& value) : modulus(value) {
+    assert(modulus.signum != Sign::Null);
+    modulus.signum = Sign::Positive;
+    Integer base(1);
+    base.shiftLimbsLeft(1);
+    Integer low = modulus % base;
+    Integer low_inverse;
+    Integer unused;
+    Integer common = gcdExtended(low, base, low_inverse, unused);
+    assert(common == 1);
+    low_inverse.signum *= Sign::Negative;
+    low_inverse %= base;
+    if (low_inverse.signum == Sign::Negative) {
+      low_inverse += base;
+    }
+    inverse = (low_inverse.signum == Sign::Null ? 0 : low_inverse.number[0]);
+    r_squared = 1;
+    r_squared.shiftLimbsLeft(2 * modulus.number.size());
+    r_squared %= modulus;
+  }
+
+  // a * b * R^(-1) mod modulus для 0 <= a, b < modulus
+  Integer multiply(const Integer& a, const Integer& b) const {
+    Integer result;
+    if (a.signum == Sign::Null || b.signum == Sign::Null) {
+      return result;
+    }
+    size_t len = modulus.number.size();
+    typename Integer::LimbVector product(2 * len + 1, 0);
+    Integer::mulLimbs(product.data(), a.number.data(), a.number.size(), b.number.data(), b.number.size());
+    Integer::reduceMontgomery(product.data(), modulus.number.data(), len, inverse);
+    result.number.assign(product.begin() + len, product.begin() + 2 * len);
+    result.signum = Sign::Positive;
+    result.clearNulls();
+    return result;
+  }
+
+  Integer toMontgomery(const Integer& value) const {
+    Integer reduced = value % modulus;
+    if (reduced.signum == Sign::Negative) {
+      reduced += modulus;
+    }
+    return multiply(reduced, r_squared);
+  }
 
-bool operator<=(const BigInteger& num1, const BigInteger& num2) {
-  return !(num2 < num1);
+  Integer fromMontgomery(const Integer& value) const {
+    return multiply(value, 1);
+  }
+
+  // base^exp mod modulus в обычной форме, exp >= 0
+  Integer pow(const Integer& base, const Integer& exp) const {
+    assert(exp.signum != Sign::Negative);
+    Integer result = powSlidingWindow(toMontgomery(base), exp, toMontgomery(1),
+                                      [this](const Integer& a, const Integer& b) { return multiply(a, b); });
+    return fromMontgomery(result);
+  }
+};
+
+// base^exp mod |mod| в [0, |mod|), exp >= 0; для модулей, не взаимно простых с kBase, - через
+// умножение и деление на заранее обращённый модуль
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> powMod(const BasicBigInteger<LimbPolicy>& base, const BasicBigInteger<LimbPolicy>& exp,
+                                   const BasicBigInteger<LimbPolicy>& mod) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  assert(mod.signum != Sign::Null && exp.signum != Sign::Negative);
+  Integer modulus = mod;
+  modulus.signum = Sign::Positive;
+  if (modulus == 1) {
+    return 0;
+  }
+  Integer limb_base(1);
+  limb_base.shiftLimbsLeft(1);
+  if (gcd(modulus % limb_base, limb_base) == 1) {
+    return MontgomeryContext<LimbPolicy>(modulus).pow(base, exp);
+  }
+  PrecomputedDivisor<LimbPolicy> divisor(modulus);
+  Integer reduced = divisor.remainder(base);
+  if (reduced.signum == Sign::Negative) {
+    reduced += modulus;
+  }
+  return powSlidingWindow(reduced, exp, Integer(1), [&divisor](const Integer& a, const Integer& b) {
+    return divisor.remainder(a * b);
+  });
 }
 
-bool operator>=(const BigInteger& num1, const BigInteger& num2) {
-  return !(num1 < num2);
+// a * b mod |mod| со знаком a * b, как у %: произведение и частное считаются в буферах потока,
+// новая память нужна только под остаток
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> mulMod(const BasicBigInteger<LimbPolicy>& a, const BasicBigInteger<LimbPolicy>& b,
+                                   const BasicBigInteger<LimbPolicy>& mod) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  assert(mod.signum != Sign::Null);
+  Integer result;
+  Sign sign = a.signum * b.signum;
+  if (sign == Sign::Null) {
+    return result;
+  }
+  size_t len = a.number.size() + b.number.size();
+  size_t len_mod = mod.number.size();
+  thread_local typename Integer::LimbVector product;
+  product.resize(len);
+  Integer::mulLimbs(product.data(), a.number.data(), a.number.size(), b.number.data(), b.number.size());
+  if (product[len - 1] == 0) {
+    len--;
+  }
+  if (len >= Integer::kNewtonDivisionThreshold + len_mod && len_mod >= Integer::kNewtonDivisionThreshold) {
+    result = Integer::fromLimbs(product.data(), len);
+    Integer::releaseScratch(product);
+    result.signum = sign;
+    return result % mod;
+  }
+  if (len < len_mod) {
+    result.number.assign(product.data(), product.data() + len);
+  } else {
+    thread_local typename Integer::LimbVector quotient;
+    quotient.resize(len - len_mod + 1);
+    result.number.resize(len_mod);
+    Integer::divModLimbs(quotient.data(), result.number.data(), product.data(), len, mod.number.data(), len_mod);
+    Integer::releaseScratch(quotient);
+  }
+  Integer::releaseScratch(product);
+  result.signum = sign;
+  result.clearNulls();
+  return result;
 }
 
-bool operator==(const BigInteger& num1, const BigInteger& num2) { return (num1 <= num2 && num2 <= num1); }
+// base^exp, exp >= 0
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> power(const BasicBigInteger<LimbPolicy>& base, uint64_t exp) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  Integer result(1);
+  Integer square = base;
+  while (exp > 0) {
+    if (exp & 1) {
+      result *= square;
+    }
+    exp >>= 1;
+    if (exp > 0) {
+      square = square.square();
+    }
+  }
+  return result;
+}
 
-bool operator!=(const BigInteger& num1, const BigInteger& num2) { return (!(num1 == num2)); }
+// 10^exp; последняя запрошенная степень запоминается, так как печать обычно идёт с одной точностью
+const BigInteger& decimalPower(uint64_t exp) {
+  thread_local uint64_t cached_exp = 0;
+  thread_local BigInteger cached(1);
+  if (cached_exp != exp) {
+    cached = power(BigInteger(10), exp);
+    cached_exp = exp;
+  }
+  return cached;
+}
 
-BigInteger operator ""_bi(unsigned long long num) {
-  BigInteger ans(num);
-  return ans;
+// log2 |value| по старшим цифрам, value != 0
+template <typename LimbPolicy>
+double log2Abs(const BasicBigInteger<LimbPolicy>& value) {
+  return std::log2(value.leadingLimbs()) +
+         static_cast<double>((value.number.size() - 1) * BasicBigInteger<LimbPolicy>::kLimbBits);
 }
 
-istream& operator>>(istream& input, BigInteger& big_integer) {
-  string str;
-  input >> str;
-  big_integer = str;
-  return input;
+// floor(value^(1 / k)) для value > 0 итерацией Ньютона x = ((k - 1) * x + value / x^(k - 1)) / k сверху:
+// начав с любого x не меньше корня, она не опускается ниже него и останавливается ровно на нём;
+// начальное приближение - плавающая оценка с запасом
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> rootFromAbove(const BasicBigInteger<LimbPolicy>& value, uint64_t k) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  double limb_bits = std::log2(static_cast<double>(Integer::kBase));
+  double root_bits = log2Abs(value) / static_cast<double>(k);
+  // старшая часть оценки занимает не больше двух цифр, остальное - сдвиг на shift цифр
+  size_t shift = 0;
+  if (root_bits >= limb_bits - 4) {
+    shift = static_cast<size_t>((root_bits - (limb_bits - 4)) / limb_bits);
+  }
+  double top = std::exp2(root_bits - static_cast<double>(shift) * limb_bits) * (1 + 1e-9);
+  typename Integer::DoubleLimb estimate = static_cast<typename Integer::DoubleLimb>(top) + 2;
+  Integer x;
+  x.number.push_back(static_cast<typename Integer::Limb>(estimate % Integer::kBase));
+  x.number.push_back(static_cast<typename Integer::Limb>(estimate / Integer::kBase));
+  x.signum = Sign::Positive;
+  x.clearNulls();
+  x.shiftLimbsLeft(shift);
+  while (true) {
+    Integer next = x * static_cast<int64_t>(k - 1) + value / power(x, k - 1);
+    Integer::divModLimb(next.number.data(), next.number.data(), next.number.size(), k);
+    next.clearNulls();
+    if (!(next < x)) {
+      return x;
+    }
+    x.swap(next);
+  }
 }
 
-ostream& operator<<(ostream& output, const BigInteger& big_integer) {
-  output << big_integer.toString();
-  return output;
+// floor(value^(1 / k)) для value > 0 с удвоением точности: корень из старших цифр value, сдвинутый на
+// shift цифр, отстаёт от настоящего меньше чем на kBase^shift, и одного шага Ньютона снизу хватает,
+// чтобы оказаться не ниже корня и выше от силы на единицу; так что на каждом уровне - одно деление
+// и одна проверка возведением в степень, а длина уровней убывает вдвое
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> rootNewton(const BasicBigInteger<LimbPolicy>& value, uint64_t k) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  size_t root_len = (value.number.size() - 1) / k;
+  if (root_len < 3) {
+    return rootFromAbove(value, k);
+  }
+  // (k - 1) / 2 * kBase^(2 * shift) / корень < 1 - ошибка после шага Ньютона
+  size_t shift = (root_len - 1) / 2;
+  Integer high = value;
+  high.shiftLimbsRight(k * shift);
+  Integer x = rootNewton(high, k);
+  x.shiftLimbsLeft(shift);
+  x = x * static_cast<int64_t>(k - 1) + value / power(x, k - 1);
+  Integer::divModLimb(x.number.data(), x.number.data(), x.number.size(), k);
+  x.clearNulls();
+  while (power(x, k) > value) {
+    x -= 1;
+  }
+  return x;
 }
 
-BigInteger gcd(BigInteger int1, BigInteger int2) {
-  if (int1 == 0) {
-    return int2;
+// floor(|value|^(1 / k)) со знаком value, k >= 1; корень чётной степени - только из неотрицательного числа
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> iroot(const BasicBigInteger<LimbPolicy>& value, uint64_t k) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  assert(k >= 1 && (k % 2 == 1 || value.signum != Sign::Negative));
+  if (k == 1 || value.signum == Sign::Null) {
+    return value;
   }
-  if (int2 == 0) {
-    return int1;
+  Integer value_abs = value;
+  value_abs.signum = Sign::Positive;
+  // |value| < 2^k
+  Integer root(1);
+  if (log2Abs(value_abs) + 1 >= static_cast<double>(k)) {
+    root = rootNewton(value_abs, k);
   }
-  int1.signum = Sign::Positive;
-  int2.signum = Sign::Positive;
-  if (int1 < int2) { int1.swap(int2); }
-  while (int2 > 0) {
-    int1 %= int2;
-    int1.swap(int2);
+  root.signum = value.signum;
+  return root;
+}
+
+// floor(sqrt(value)), value >= 0
+template <typename LimbPolicy>
+BasicBigInteger<LimbPolicy> isqrt(const BasicBigInteger<LimbPolicy>& value) {
+  return iroot(value, 2);
+}
+
+// простота q < 2^32 по Миллеру-Рабину с основаниями 2, 7, 61 (для таких q проверка точная)
+bool isPrimeWord(uint32_t q) {
+  if (q < 2) {
+    return false;
+  }
+  for (uint32_t small : {2u, 3u, 5u, 7u, 61u}) {
+    if (q % small == 0) {
+      return q == small;
+    }
+  }
+  uint32_t odd = q - 1;
+  int twos = 0;
+  while (odd % 2 == 0) {
+    odd /= 2;
+    twos++;
+  }
+  for (uint32_t witness : {2u, 7u, 61u}) {
+    uint64_t x = BigInteger::powModWord(witness, odd, q);
+    if (x == 1 || x == q - 1) {
+      continue;
+    }
+    for (int i = 1; i < twos && x != q - 1; i++) {
+      x = x * x % q;
+    }
+    if (x != q - 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// может ли value > 0 быть p-й степенью: по модулю простого q = 1 (mod p) p-е степени - подгруппа из
+// (q - 1) / p вычетов, и не-степень проходит каждую проверку с вероятностью около 1 / p
+template <typename LimbPolicy>
+bool passesPowerResidueTests(const BasicBigInteger<LimbPolicy>& value, uint32_t p) {
+  const int kPowerResidueTests = 8;
+  int tests = 0;
+  for (uint64_t q = 2 * uint64_t(p) + 1; tests < kPowerResidueTests && q < (uint64_t(1) << 32); q += 2 * p) {
+    if (!isPrimeWord(static_cast<uint32_t>(q))) {
+      continue;
+    }
+    tests++;
+    uint32_t rest = static_cast<uint32_t>(value.modWord(static_cast<int64_t>(q)));
+    if (rest != 0 && BasicBigInteger<LimbPolicy>::powModWord(rest, (q - 1) / p, static_cast<uint32_t>(q)) != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// является ли value точной степенью root^exponent с exponent >= 2; exponent - наибольший из возможных
+// (для 0 и 1 - 2, для -1 - 3). Перебираются простые p до log2 |value|: если корень степени p меньше
+// 2^32, его даёт плавающая оценка, иначе корень извлекается только после проверок вычетами
+template <typename LimbPolicy>
+bool isPerfectPower(const BasicBigInteger<LimbPolicy>& value, BasicBigInteger<LimbPolicy>& root, uint64_t& exponent) {
+  using Integer = BasicBigInteger<LimbPolicy>;
+  if (value.number.size() == 1 && value.number[0] == 1) {
+    root = value;
+    exponent = (value.signum == Sign::Negative ? 3 : 2);
+    return true;
+  }
+  if (value.signum == Sign::Null) {
+    root = value;
+    exponent = 2;
+    return true;
+  }
+  // проверка кандидата в корни по модулю наибольшего простого меньше 2^32 до точного возведения в степень
+  const uint32_t kCheckModulus = 4294967291u;
+  Integer base = value;
+  base.signum = Sign::Positive;
+  exponent = 1;
+  vector<uint32_t> primes = primesUpTo(static_cast<uint64_t>(log2Abs(base)) + 1);
+  for (size_t i = 0; i < primes.size(); i++) {
+    uint32_t p = primes[i];
+    if (value.signum == Sign::Negative && p == 2) {
+      continue;
+    }
+    double root_bits = log2Abs(base) / p;
+    if (root_bits < 1) {
+      break;
+    }
+    Integer candidate;
+    if (root_bits < 32) {
+      double estimate = std::exp2(root_bits);
+      double rounded = std::round(estimate);
+      if (std::abs(estimate - rounded) > 1e-3 ||
+          Integer::powModWord(static_cast<uint64_t>(rounded), p, kCheckModulus) != base.modWord(kCheckModulus)) {
+        continue;
+      }
+      candidate.setMagnitude(static_cast<uint64_t>(rounded));
+      candidate.signum = Sign::Positive;
+    } else {
+      if (!passesPowerResidueTests(base, p)) {
+        continue;
+      }
+      candidate = iroot(base, p);
+    }
+    if (power(candidate, p) == base) {
+      base.swap(candidate);
+      exponent *= p;
+      // та же степень может войти ещё раз
+      i--;
+    }
+  }
+  if (exponent == 1) {
+    return false;
   }
-  return int1;
+  root = base;
+  root.signum = value.signum;
+  return true;
+}
+
+template <typename LimbPolicy>
+bool isPerfectPower(const BasicBigInteger<LimbPolicy>& value) {
+  BasicBigInteger<LimbPolicy> root;
+  uint64_t exponent;
+  return isPerfectPower(value, root, exponent);
 }
 
-void beautify(BigInteger& numerator, BigInteger& denumerator) {
-  BigInteger common_part = gcd(numerator, denumerator);
-  numerator /= common_part;
-  denumerator /= common_part;
+template <typename LimbPolicy>
+void beautify(BasicBigInteger<LimbPolicy>& numerator, BasicBigInteger<LimbPolicy>& denumerator) {
+  BasicBigInteger<LimbPolicy> common_part = gcd(numerator, denumerator);
+  if (common_part != 1) {
+    numerator /= common_part;
+    denumerator /= common_part;
+  }
   numerator.signum *= denumerator.signum;
   denumerator.signum = Sign::Positive;
 }
 
+// много BigInteger в одном непрерывном буфере: цифры всех чисел лежат подряд в limbs, а для каждого
+// числа хранятся смещение, длина, вместимость места и знак. Поэлементные операции идут на месте одним
+// проходом по буферу; если хоть одному числу может не хватить места, буфер сначала один раз
+// переупаковывается с запасом
+struct BigIntVector {
+  using Limb = BigInteger::Limb;
+
+  struct Entry {
+    size_t offset = 0;
+    size_t length = 0;
+    size_t capacity = 0;
+    Sign signum = Sign::Null;
+  };
+
+  vector<Limb> limbs;
+  vector<Entry> entries;
+
+  BigIntVector() = default;
+
+  BigIntVector(const vector<BigInteger>& values) {
+    size_t total = 0;
+    for (const BigInteger& value : values) {
+      total += value.number.size() + 1;
+    }
+    reserve(values.size(), total);
+    for (const BigInteger& value : values) {
+      push_back(value);
+    }
+  }
+
+  size_t size() const {
+    return entries.size();
+  }
+
+  bool empty() const {
+    return entries.empty();
+  }
+
+  void reserve(size_t count, size_t limb_count) {
+    entries.reserve(count);
+    limbs.reserve(limb_count);
+  }
+
+  void clear() {
+    entries.clear();
+    limbs.clear();
+  }
+
+  void push_back(const BigInteger& value) {
+    entries.push_back({limbs.size(), value.number.size(), value.number.size() + 1, value.signum});
+    limbs.insert(limbs.end(), value.number.begin(), value.number.end());
+    limbs.push_back(0);
+  }
+
+  BigInteger operator[](size_t index) const {
+    const Entry& entry = entries[index];
+    BigInteger value;
+    value.number.assign(limbs.data() + entry.offset, limbs.data() + entry.offset + entry.length);
+    value.signum = entry.signum;
+    return value;
+  }
+
+  void set(size_t index, const BigInteger& value) {
+    Entry& entry = entries[index];
+    if (value.number.size() > entry.capacity) {
+      // новое место - в конце буфера, старое остаётся пустым до compact()
+      entry.offset = limbs.size();
+      entry.capacity = value.number.size() + 1;
+      limbs.resize(entry.offset + entry.capacity, 0);
+    }
+    std::copy(value.number.begin(), value.number.end(), limbs.begin() + entry.offset);
+    entry.length = value.number.size();
+    entry.signum = value.signum;
+  }
+
+  vector<BigInteger> toVector() const {
+    vector<BigInteger> values(size());
+    for (size_t i = 0; i < size(); i++) {
+      values[i] = (*this)[i];
+    }
+    return values;
+  }
+
+  // переупаковка чисел подряд в порядке индексов: i-е получает max(need(i), length) цифр и одну запасную
+  template <typename Need>
+  void repack(Need need) {
+    size_t total = 0;
+    for (size_t i = 0; i < size(); i++) {
+      total += std::max(need(i), entries[i].length) + 1;
+    }
+    vector<Limb> packed(total, 0);
+    size_t offset = 0;
+    for (size_t i = 0; i < size(); i++) {
+      Entry& entry = entries[i];
+      std::copy(limbs.begin() + entry.offset, limbs.begin() + entry.offset + entry.length, packed.begin() + offset);
+      entry.offset = offset;
+      entry.capacity = std::max(need(i), entry.length) + 1;
+      offset += entry.capacity;
+    }
+    limbs.swap(packed);
+  }
+
+  // места под результат операции: переупаковка, только если кому-то из чисел не хватает вместимости
+  template <typename Need>
+  void reserveLimbs(Need need) {
+    for (size_t i = 0; i < size(); i++) {
+      if (need(i) > entries[i].capacity) {
+        repack(need);
+        return;
+      }
+    }
+  }
+
+  // возвращает место, освободившееся после set(), оставляя по одной запасной цифре
+  void compact() {
+    repack([](size_t) { return size_t(0); });
+  }
+
+  // this[i] += sign * other[i] для всех i; other может совпадать с *this
+  BigIntVector& addVector(const BigIntVector& other, Sign sign) {
+    assert(size() == other.size());
+    reserveLimbs([this, &other](size_t i) {
+      return (other.entries[i].signum == Sign::Null ? 0 : std::max(entries[i].length, other.entries[i].length) + 1);
+    });
+    for (size_t i = 0; i < size(); i++) {
+      Entry& entry = entries[i];
+      const Entry& term = other.entries[i];
+      Sign term_sign = term.signum * sign;
+      if (term_sign == Sign::Null) {
+        continue;
+      }
+      size_t len_a = entry.length;
+      size_t len_b = term.length;
+      size_t len = std::max(len_a, len_b);
+      Limb* res = limbs.data() + entry.offset;
+      const Limb* b = other.limbs.data() + term.offset;
+      std::fill(res + len_a, res + len, 0);
+      if (entry.signum == Sign::Null || entry.signum == term_sign) {
+        res[len] = BigInteger::addLimbs(res, res, len, b, len_b);
+        len += (res[len] != 0);
+        entry.signum = term_sign;
+      } else if (BigInteger::cmpAbs(res, len_a, b, len_b) >= 0) {
+        BigInteger::subLimbs(res, res, len, b, len_b);
+      } else {
+        // |b| > |a|: вычитаем в обратную сторону прямо в место a
+        BigInteger::subLimbs(res, b, len_b, res, len_a);
+        entry.signum = term_sign;
+      }
+      while (len > 0 && res[len - 1] == 0) {
+        --len;
+      }
+      entry.length = len;
+      if (len == 0) {
+        entry.signum = Sign::Null;
+      }
+    }
+    return *this;
+  }
+
+  BigIntVector& operator+=(const BigIntVector& other) {
+    return addVector(other, Sign::Positive);
+  }
+
+  BigIntVector& operator-=(const BigIntVector& other) {
+    return addVector(other, Sign::Negative);
+  }
+
+  // умножение каждого числа на цифру со знаком
+  BigIntVector& operator*=(int64_t num) {
+    if (num == 0) {
+      for (Entry& entry : entries) {
+        entry.length = 0;
+        entry.signum = Sign::Null;
+      }
+      return *this;
+    }
+    uint64_t magnitude = (num < 0 ? 0 - static_cast<uint64_t>(num) : num);
+    if (magnitude >= BigInteger::kBase) {
+      // множитель длиннее одной цифры - поэлементно через BigInteger
+      for (size_t i = 0; i < size(); i++) {
+        set(i, (*this)[i] * num);
+      }
+      return *this;
+    }
+    Sign sign = (num < 0 ? Sign::Negative : Sign::Positive);
+    reserveLimbs([this](size_t i) { return entries[i].length + 1; });
+    for (Entry& entry : entries) {
+      Limb* res = limbs.data() + entry.offset;
+      res[entry.length] = BigInteger::mulLimb(res, res, entry.length, static_cast<Limb>(magnitude));
+      entry.length += (res[entry.length] != 0);
+      entry.signum *= sign;
+    }
+    return *this;
+  }
+
+  // знаки this[i] - other[i]: -1, 0 или 1
+  vector<int> compare(const BigIntVector& other) const {
+    assert(size() == other.size());
+    vector<int> result(size());
+    for (size_t i = 0; i < size(); i++) {
+      const Entry& a = entries[i];
+      const Entry& b = other.entries[i];
+      if (a.signum != b.signum) {
+        result[i] = (a.signum < b.signum ? -1 : 1);
+        continue;
+      }
+      int cmp = BigInteger::cmpAbs(limbs.data() + a.offset, a.length, other.limbs.data() + b.offset, b.length);
+      result[i] = (a.signum == Sign::Negative ? -cmp : cmp);
+    }
+    return result;
+  }
+
+  // положительные и отрицательные числа копятся отдельно, разность модулей берётся один раз в конце
+  BigInteger sum() const {
+    BigInteger positive;
+    BigInteger negative;
+    for (const Entry& entry : entries) {
+      if (entry.signum != Sign::Null) {
+        BigInteger& total = (entry.signum == Sign::Positive ? positive : negative);
+        BigInteger::addAbs(total.number, limbs.data() + entry.offset, entry.length);
+        total.signum = entry.signum;
+      }
+    }
+    positive += negative;
+    return positive;
+  }
+};
+
 struct Rational {
   BigInteger numerator;
   BigInteger denumerator;
+  // ленивая дробь не сокращается после каждой операции: сокращение откладывается до вывода или до
+  // момента, когда знаменатель вырастет больше чем вдвое и ещё на kLazyReductionLimbs цифр с последнего
+  // сокращения; сравнения работают и с несократимой дробью, потому что знаменатель всегда положителен
+  bool lazy = false;
+  // известно, что дробь несократима
+  bool reduced = true;
+  // длина знаменателя после последнего сокращения
+  size_t reduced_limbs = 1;
+  static const size_t kLazyReductionLimbs = 2;
 
   Rational() : numerator(0), denumerator(1) {}
 
-  Rational(const BigInteger& numerator, const BigInteger& denumerator)
-      : numerator(numerator), denumerator(denumerator) {}
+  // дробь не сокращается, пока не понадобится; знак переносится в числитель сразу
+  Rational(BigInteger numerator, BigInteger denumerator)
+      : numerator(std::move(numerator)), denumerator(std::move(denumerator)), reduced(false) {
+    this->numerator.signum *= this->denumerator.signum;
+    this->denumerator.signum = Sign::Positive;
+  }
 
   Rational(int numer, int denumer) : numerator(numer), denumerator(denumer) {
-    beautify(numerator, denumerator);
+    reduce();
   }
 
   Rational(int numerator) : numerator(numerator), denumerator(1_bi) {}
 
-  Rational(const BigInteger& numerator) : numerator(numerator), denumerator(1_bi) {}
+  Rational(BigInteger numerator) : numerator(std::move(numerator)), denumerator(1_bi) {}
+
+  // сокращает дробь сейчас
+  Rational& reduce() {
+    beautify(numerator, denumerator);
+    reduced = true;
+    reduced_limbs = denumerator.number.size();
+    return *this;
+  }
+
+  // выключение ленивого режима сразу сокращает дробь
+  Rational& setLazy(bool value) {
+    lazy = value;
+    if (!lazy && !reduced) {
+      reduce();
+    }
+    return *this;
+  }
+
+  string toString() const {
+    if (!reduced) {
+      Rational copy = *this;
+      return copy.reduce().toString();
+    }
+    string ans = numerator.toString();
+    if (denumerator != 1) {
+      ans += "/" + denumerator.toString();
+    }
+    return ans;
+  }
+
+  // ближайшее к дроби double (округление к чётному, с денормализованными числами и бесконечностью):
+  // частное, сдвинутое на цифры так, чтобы в нём было 2-3 цифры, находится одним делением, а
+  // остаток и младшая цифра идут в бит "дальше есть ненулевые"
+  double toDouble() const {
+    if (numerator.signum == Sign::Null) {
+      return 0.0;
+    }
+    const int64_t kLimbBits = BigInteger::kLimbBits;
+    double sign = (numerator.signum == Sign::Negative ? -1.0 : 1.0);
+    int64_t len_a = numerator.number.size();
+    int64_t len_b = denumerator.number.size();
+    if (kLimbBits * (len_a - len_b - 1) >= 1024) {
+      return sign * HUGE_VAL;
+    }
+    if (kLimbBits * (len_b - len_a - 1) > 1075) {
+      return sign * 0.0;
+    }
+    BigInteger dividend = numerator;
+    BigInteger divisor = denumerator;
+    dividend.signum = Sign::Positive;
+    divisor.signum = Sign::Positive;
+    // частное не короче 65 бит
+    int64_t shift = len_b - len_a + 1 + 64 / kLimbBits;
+    if (shift > 0) {
+      dividend.shiftLimbsLeft(shift);
+    } else {
+      divisor.shiftLimbsLeft(-shift);
+    }
+    BigInteger quotient;
+    BigInteger remainder;
+    BigInteger::divMod(dividend, divisor, quotient, remainder);
+    // значение = (top + остаток) * 2^low_bits * kBase^-shift: в top старшие 64 бита частного,
+    // остальные биты и остаток от деления нужны только как sticky
+    bool sticky = (remainder.signum != Sign::Null);
+    size_t len = quotient.number.size();
+    int64_t low_bits = static_cast<int64_t>(len - 1) * kLimbBits + std::bit_width(quotient.number[len - 1]) - 64;
+    size_t low_limbs = static_cast<size_t>(low_bits / kLimbBits);
+    uint64_t top = 0;
+    for (size_t i = len; i-- > low_limbs;) {
+      int64_t pos = static_cast<int64_t>(i) * kLimbBits - low_bits;
+      top |= (pos >= 0 ? static_cast<uint64_t>(quotient.number[i]) << pos
+                       : static_cast<uint64_t>(quotient.number[i]) >> -pos);
+    }
+    BigInteger::Limb low_mask = (BigInteger::Limb(1) << (low_bits % kLimbBits)) - 1;
+    sticky |= ((quotient.number[low_limbs] & low_mask) != 0);
+    for (size_t i = 0; i < low_limbs; i++) {
+      sticky |= (quotient.number[i] != 0);
+    }
+    int64_t exponent = 63 + low_bits - kLimbBits * shift;
+    if (exponent >= 1024) {
+      return sign * HUGE_VAL;
+    }
+    // меньше половины наименьшего денормализованного
+    if (exponent < -1075) {
+      return sign * 0.0;
+    }
+    int precision = (exponent >= -1022 ? 53 : static_cast<int>(exponent + 1075));
+    int drop = 64 - precision;
+    uint64_t mantissa = (drop == 64 ? 0 : top >> drop);
+    uint64_t rest = (drop == 64 ? top : top - (mantissa << drop));
+    uint64_t half = uint64_t(1) << (drop - 1);
+    if (rest > half || (rest == half && (sticky || (mantissa & 1) != 0))) {
+      ++mantissa;
+    }
+    return sign * std::ldexp(static_cast<double>(mantissa), static_cast<int>(drop + low_bits - kLimbBits * shift));
+  }
+
+  explicit operator double() const {
+    return toDouble();
+  }
+
+  Rational& operator+=(const Rational& rational) {
+    return addRational(rational, Sign::Positive);
+  }
+
+  Rational& operator-=(const Rational& rational) {
+    return addRational(rational, Sign::Negative);
+  }
+
+  // *this += a * b и *this -= a * b: целые дроби (например, элементы целочисленной матрицы) складываются
+  // через addProduct числителей без временного произведения, остальные - обычным умножением и сложением
+  Rational& addMul(const Rational& a, const Rational& b) {
+    return addProduct(a, b, Sign::Positive);
+  }
+
+  Rational& subMul(const Rational& a, const Rational& b) {
+    return addProduct(a, b, Sign::Negative);
+  }
+
+  Rational& addProduct(const Rational& a, const Rational& b, Sign sign) {
+    if (denumerator == 1 && a.denumerator == 1 && b.denumerator == 1) {
+      numerator.addProduct(a.numerator, b.numerator, sign);
+      return *this;
+    }
+    return addRational(a * b, sign);
+  }
+
+  // *this += sign * rational. Для несократимых дробей a / b и c / d (Кнут, 4.5.1) при g = gcd(b, d) = 1
+  // сумма (a * d + c * b) / (b * d) уже несократима, иначе t = a * (d / g) + c * (b / g) сокращается
+  // только на gcd(t, g) - два НОДа коротких чисел вместо одного длинного
+  Rational& addRational(const Rational& rational, Sign sign) {
+    if (&rational == this) {
+      Rational copy = rational;
+      return addRational(copy, sign);
+    }
+    // у однозначных знаменателей лишние НОД и деления дороже, чем сократить результат целиком
+    bool short_denumerators = (denumerator.number.size() == 1 && rational.denumerator.number.size() == 1);
+    if (lazy || !reduced || !rational.reduced || short_denumerators) {
+      if (denumerator == rational.denumerator) {
+        numerator.addSigned(rational.numerator.number.data(), rational.numerator.number.size(),
+                            rational.numerator.signum * sign);
+      } else {
+        numerator *= rational.denumerator;
+        numerator.addProduct(rational.numerator, denumerator, sign);
+        denumerator *= rational.denumerator;
+      }
+      return settle();
+    }
+    BigInteger common = gcd(denumerator, rational.denumerator);
+    if (common == 1) {
+      numerator *= rational.denumerator;
+      numerator.addProduct(rational.numerator, denumerator, sign);
+      denumerator *= rational.denumerator;
+      return *this;
+    }
+    denumerator /= common;
+    numerator *= rational.denumerator / common;
+    numerator.addProduct(rational.numerator, denumerator, sign);
+    BigInteger rest = gcd(numerator, common);
+    if (rest == 1) {
+      denumerator *= rational.denumerator;
+    } else {
+      numerator /= rest;
+      denumerator *= rational.denumerator / rest;
+    }
+    return *this;
+  }
+
+  // для несократимых дробей перекрёстное сокращение: (a / gcd(a, d)) * (c / gcd(c, b)) над
+  // (b / gcd(c, b)) * (d / gcd(a, d)) уже несократимо
+  Rational& operator*=(const Rational& rational) {
+    if (&rational == this) {
+      // квадрат несократимой дроби несократим
+      numerator = numerator.square();
+      denumerator = denumerator.square();
+      return (reduced ? *this : settle());
+    }
+    if (lazy || !reduced || !rational.reduced) {
+      numerator *= rational.numerator;
+      denumerator *= rational.denumerator;
+      return settle();
+    }
+    crossMultiply(rational.numerator, rational.denumerator);
+    return *this;
+  }
+
+  // деление - умножение на перевёрнутую дробь, знак делителя переносится в числитель
+  Rational& operator/=(const Rational& rational) {
+    if (&rational == this) {
+      Rational copy = rational;
+      return *this /= copy;
+    }
+    if (lazy || !reduced || !rational.reduced) {
+      numerator *= rational.denumerator;
+      denumerator *= rational.numerator;
+      numerator.signum *= denumerator.signum;
+      denumerator.signum = Sign::Positive;
+      return settle();
+    }
+    crossMultiply(rational.denumerator, rational.numerator);
+    numerator.signum *= denumerator.signum;
+    denumerator.signum = Sign::Positive;
+    return *this;
+  }
+
+  // *this *= other_numerator / other_denumerator для несократимых дробей
+  void crossMultiply(const BigInteger& other_numerator, const BigInteger& other_denumerator) {
+    if (numerator.signum == Sign::Null || other_numerator.signum == Sign::Null) {
+      numerator.toNull();
+      denumerator = 1;
+      return;
+    }
+    BigInteger first = gcd(numerator, other_denumerator);
+    BigInteger second = gcd(other_numerator, denumerator);
+    if (first != 1) {
+      numerator /= first;
+    }
+    if (second != 1) {
+      denumerator /= second;
+    }
+    numerator *= (second == 1 ? other_numerator : other_numerator / second);
+    denumerator *= (first == 1 ? other_denumerator : other_denumerator / first);
+  }
+
+  // после арифметики без сокращения: обычная дробь сокращается сразу, ленивая - когда знаменатель вырос
+  Rational& settle() {
+    if (!lazy || denumerator.number.size() > 2 * reduced_limbs + kLazyReductionLimbs) {
+      return reduce();
+    }
+    reduced = false;
+    return *this;
+  }
+
+  // как и у BigInteger, временный операнд используется под результат
+  Rational operator+(const Rational& rational) const& {
+    Rational copy = *this;
+    copy += rational;
+    return copy;
+  }
+
+  Rational operator+(const Rational& rational) && {
+    *this += rational;
+    return std::move(*this);
+  }
 
-  string toString() const {
-    string ans = numerator.toString();
-    if (denumerator != 1) {
-      ans += "/" + denumerator.toString();
-    }
-    return ans;
+  Rational operator+(Rational&& rational) const& {
+    rational += *this;
+    return std::move(rational);
   }
 
-  explicit operator double() {
-    double num = std::stod(numerator.toString());
-    double denum = std::stod(denumerator.toString());
-    return num / denum;
+  Rational operator+(Rational&& rational) && {
+    *this += rational;
+    return std::move(*this);
   }
 
-  Rational& operator+=(const Rational& rational) {
-    numerator = (numerator * rational.denumerator) + (rational.numerator * denumerator);
-    denumerator *= rational.denumerator;
-    beautify(numerator, denumerator);
-    return *this;
+  Rational operator-(const Rational& rational) const& {
+    Rational copy = *this;
+    copy -= rational;
+    return copy;
   }
 
-  Rational& operator-=(const Rational& rational) {
-    numerator = (numerator * rational.denumerator) - (rational.numerator * denumerator);
-    denumerator *= rational.denumerator;
-    beautify(numerator, denumerator);
-    return *this;
+  Rational operator-(const Rational& rational) && {
+    *this -= rational;
+    return std::move(*this);
   }
 
-  Rational& operator*=(const Rational& rational) {
-    numerator *= rational.numerator;
-    denumerator *= rational.denumerator;
-    beautify(numerator, denumerator);
-    return *this;
+  Rational operator-(Rational&& rational) const& {
+    rational -= *this;
+    rational.numerator.signum *= Sign::Negative;
+    return std::move(rational);
   }
 
-  Rational& operator/=(const Rational& rational) {
-    denumerator *= rational.numerator;
-    numerator *= rational.denumerator;
-    beautify(numerator, denumerator);
-    return *this;
+  Rational operator-(Rational&& rational) && {
+    *this -= rational;
+    return std::move(*this);
   }
 
-  Rational operator+(const Rational& rational) const {
+  Rational operator*(const Rational& rational) const& {
     Rational copy = *this;
-    return copy += rational;
+    copy *= rational;
+    return copy;
   }
 
-  Rational operator-(const Rational& rational) const {
-    Rational copy = *this;
-    return copy -= rational;
+  Rational operator*(const Rational& rational) && {
+    *this *= rational;
+    return std::move(*this);
   }
 
-  Rational operator*(const Rational& rational) const {
-    Rational copy = *this;
-    return copy *= rational;
+  Rational operator*(Rational&& rational) const& {
+    rational *= *this;
+    return std::move(rational);
+  }
+
+  Rational operator*(Rational&& rational) && {
+    *this *= rational;
+    return std::move(*this);
   }
 
-  Rational operator/(const Rational& rational) const {
+  Rational operator/(const Rational& rational) const& {
     Rational copy = *this;
-    return copy /= rational;
+    copy /= rational;
+    return copy;
+  }
+
+  Rational operator/(const Rational& rational) && {
+    *this /= rational;
+    return std::move(*this);
   }
 
-  Rational operator-() {
+  Rational operator-() const& {
     Rational copy = *this;
     copy.numerator.signum *= Sign::Negative;
     return copy;
   }
 
+  Rational operator-() && {
+    numerator.signum *= Sign::Negative;
+    return std::move(*this);
+  }
+
+  // |дробь| ~ mantissa * 2^exponent, mantissa в [0.5, 1) по старшим цифрам числителя и знаменателя
+  // с относительной ошибкой меньше 2^-50; числитель ненулевой
+  void estimate(double& mantissa, int64_t& exponent) const {
+    int shift = 0;
+    mantissa = std::frexp(numerator.leadingLimbs() / denumerator.leadingLimbs(), &shift);
+    exponent = shift + static_cast<int64_t>(BigInteger::kLimbBits) *
+                           (static_cast<int64_t>(numerator.number.size()) -
+                            static_cast<int64_t>(denumerator.number.size()));
+  }
+
+  // знак (*this - rhs): сначала знаки, потом оценка модулей по старшим цифрам, и только если
+  // оценки ближе их погрешности - точное сравнение произведений крест-накрест
+  int compare(const Rational& rhs) const {
+    if (numerator.signum != rhs.numerator.signum) {
+      return (numerator.signum < rhs.numerator.signum ? -1 : 1);
+    }
+    if (numerator.signum == Sign::Null) {
+      return 0;
+    }
+    int sign = (numerator.signum == Sign::Negative ? -1 : 1);
+    double mantissa = 0;
+    double rhs_mantissa = 0;
+    int64_t exponent = 0;
+    int64_t rhs_exponent = 0;
+    estimate(mantissa, exponent);
+    rhs.estimate(rhs_mantissa, rhs_exponent);
+    if (exponent != rhs_exponent) {
+      if (exponent > rhs_exponent + 1 || rhs_exponent > exponent + 1) {
+        return (exponent > rhs_exponent ? sign : -sign);
+      }
+      (exponent > rhs_exponent ? mantissa : rhs_mantissa) *= 2;
+    }
+    const double kError = 1e-14;
+    if (mantissa > rhs_mantissa * (1 + kError)) {
+      return sign;
+    }
+    if (rhs_mantissa > mantissa * (1 + kError)) {
+      return -sign;
+    }
+    BigInteger left = numerator * rhs.denumerator;
+    BigInteger right = denumerator * rhs.numerator;
+    return (left < right ? -1 : (right < left ? 1 : 0));
+  }
+
   bool operator<(const Rational& rhs) const {
-    return numerator * rhs.denumerator < denumerator * rhs.numerator;
+    return compare(rhs) < 0;
   }
 
   bool operator>(const Rational& rhs) const { return rhs < *this; }
@@ -667,62 +3562,67 @@ struct Rational {
 
   bool operator>=(const Rational& rhs) const { return !(*this < rhs); }
 
-  bool operator==(const Rational& rhs) const { return *this <= rhs && *this >= rhs; }
+  // у несократимых дробей равны сами числители и знаменатели
+  bool operator==(const Rational& rhs) const {
+    if (reduced && rhs.reduced) {
+      return numerator == rhs.numerator && denumerator == rhs.denumerator;
+    }
+    return compare(rhs) == 0;
+  }
 
   bool operator!=(const Rational& rhs) const { return !(rhs == *this); }
 
-  string asDecimal(size_t precision = 0) {
-    Rational copy = *this;
-    string ans;
-    if (numerator.signum == Sign::Negative) {
-      ans += "-";
-      numerator.signum = Sign::Positive;
-    }
-    if (precision == 0) {
-      if (numerator >= denumerator) {
-        ans += "1";
-        return ans;
-      } else {
-        return "0";
-      }
+  // запись с precision знаками после точки, лишние знаки отбрасываются: модуль умножается на
+  // 10^precision и делится на знаменатель один раз, точка ставится в десятичной записи частного
+  string asDecimal(size_t precision = 0) const {
+    BigInteger scaled = numerator;
+    if (scaled.signum != Sign::Null) {
+      scaled.signum = Sign::Positive;
     }
-    if (numerator > denumerator) {
-      ans += (numerator / denumerator).toString();
-      numerator %= denumerator;
-      ans += ".";
-    } else {
-      ans += "0.";
+    if (precision > 0) {
+      scaled *= decimalPower(precision);
     }
-    for (size_t i = 0; i < precision; i++) {
-      numerator *= 10;
-      ans += (numerator / denumerator).toString();
-      numerator %= denumerator;
+    BigInteger quotient;
+    BigInteger remainder;
+    BigInteger::divMod(scaled, denumerator, quotient, remainder);
+    string digits = quotient.toString();
+    if (digits.size() <= precision) {
+      digits.insert(0, precision + 1 - digits.size(), '0');
     }
-    *this = copy;
-    return ans;
+    if (precision > 0) {
+      digits.insert(digits.size() - precision, ".");
+    }
+    if (numerator.signum == Sign::Negative && (precision > 0 || quotient.signum != Sign::Null)) {
+      digits.insert(0, "-");
+    }
+    return digits;
   }
 };
 
 Rational operator+(int num_1, const Rational& num_2) {
   Rational rational(num_1);
-  return rational + num_2;
+  return std::move(rational) + num_2;
 }
 
 Rational operator-(int num_1, const Rational& num_2) {
   Rational rational(num_1);
-  return rational - num_2;
+  return std::move(rational) - num_2;
 }
 
 Rational operator*(int num_1, const Rational& num_2) {
   Rational rational(num_1);
-  return rational * num_2;
+  return std::move(rational) * num_2;
 }
 
 Rational operator/(int num_1, const Rational& num_2) {
   Rational rational(num_1);
-  return rational / num_2;
+  return std::move(rational) / num_2;
 }
 ostream& operator<<(ostream& output, const Rational& rational) {
+  if (!rational.reduced) {
+    Rational copy = rational;
+    return output << copy.reduce();
+  }
   return output << rational.numerator << "/" << rational.denumerator;
 }
 istream& operator>>(istream& input, Rational& rational) {
@@ -748,10 +3648,614 @@ istream& operator>>(istream& input, Rational& rational) {
   } else {
     rational.denumerator = 1;
   }
-  beautify(rational.numerator, rational.denumerator);
+  rational.reduce();
   return input;
 }
 
+// дробь, которая, пока числитель и знаменатель помещаются в int64_t, хранит их прямо в объекте и
+// считает встроенной арифметикой с проверкой переполнения (__builtin_*_overflow) и двоичным НОД;
+// операция, которая переполнилась, повторяется над Rational, и дробь становится длинной. Длинная дробь
+// возвращается в короткую, как только снова помещается, так что короткая и длинная формы одного
+// числа не встречаются. Короткая дробь несократима, знаменатель положителен, числитель не равен INT64_MIN
+struct HybridRational {
+  int64_t small_numerator = 0;
+  int64_t small_denumerator = 1;
+  std::unique_ptr<Rational> big;
+
+  HybridRational() = default;
+
+  HybridRational(int64_t numerator) {
+    if (numerator == INT64_MIN) {
+      setRational(toRational(numerator, 1));
+    } else {
+      small_numerator = numerator;
+    }
+  }
+
+  HybridRational(int64_t numerator, int64_t denumerator) {
+    assert(denumerator != 0);
+    if (numerator == INT64_MIN || denumerator == INT64_MIN) {
+      Rational value = toRational(numerator, denumerator);
+      setRational(std::move(value.reduce()));
+      return;
+    }
+    if (denumerator < 0) {
+      numerator = -numerator;
+      denumerator = -denumerator;
+    }
+    int64_t common = static_cast<int64_t>(binaryGcd(magnitude(numerator), denumerator));
+    small_numerator = numerator / common;
+    small_denumerator = denumerator / common;
+  }
+
+  HybridRational(const BigInteger& value) {
+    setRational(Rational(value));
+  }
+
+  HybridRational(const Rational& value) {
+    Rational copy = value;
+    setRational(std::move(copy.reduce()));
+  }
+
+  HybridRational(const HybridRational& other)
+      : small_numerator(other.small_numerator), small_denumerator(other.small_denumerator) {
+    if (other.big) {
+      big = std::make_unique<Rational>(*other.big);
+    }
+  }
+
+  HybridRational(HybridRational&& other) noexcept = default;
+
+  HybridRational& operator=(const HybridRational& other) {
+    if (this != &other) {
+      HybridRational copy = other;
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  HybridRational& operator=(HybridRational&& other) noexcept = default;
+
+  bool isSmall() const {
+    return big == nullptr;
+  }
+
+  Rational toRational() const {
+    return big ? *big : toRational(small_numerator, small_denumerator);
+  }
+
+  static uint64_t magnitude(int64_t value) {
+    return (value < 0 ? 0 - static_cast<uint64_t>(value) : value);
+  }
+
+  // numerator / denumerator как Rational, знаменатель ненулевой
+  static Rational toRational(int64_t numerator, int64_t denumerator) {
+    BigInteger numer;
+    BigInteger denum;
+    numer += numerator;
+    denum += denumerator;
+    Rational value(std::move(numer), std::move(denum));
+    value.reduced = (binaryGcd(magnitude(numerator), magnitude(denumerator)) == 1);
+    return value;
+  }
+
+  // длинное значение value (несократимое) - в короткую форму, если помещается
+  void setRational(Rational&& value) {
+    const BigInteger& numer = value.numerator;
+    const BigInteger& denum = value.denumerator;
+    if (numer.number.size() * BigInteger::kLimbBits <= 64 && denum.number.size() * BigInteger::kLimbBits <= 64 &&
+        numer.magnitudeWord() <= INT64_MAX && denum.magnitudeWord() <= INT64_MAX) {
+      small_numerator = static_cast<int64_t>(numer.magnitudeWord());
+      if (numer.signum == Sign::Negative) {
+        small_numerator = -small_numerator;
+      }
+      small_denumerator = static_cast<int64_t>(denum.magnitudeWord());
+      big.reset();
+      return;
+    }
+    if (big) {
+      *big = std::move(value);
+    } else {
+      big = std::make_unique<Rational>(std::move(value));
+    }
+  }
+
+  // *this += numer / denum для коротких несократимых дробей (Кнут, 4.5.1); false при переполнении
+  bool addSmall(int64_t numer, int64_t denum) {
+    int64_t common = static_cast<int64_t>(binaryGcd(small_denumerator, denum));
+    int64_t left = 0;
+    int64_t right = 0;
+    int64_t sum = 0;
+    if (__builtin_mul_overflow(small_numerator, denum / common, &left) ||
+        __builtin_mul_overflow(numer, small_denumerator / common, &right) || __builtin_add_overflow(left, right, &sum) ||
+        sum == INT64_MIN) {
+      return false;
+    }
+    int64_t rest = static_cast<int64_t>(binaryGcd(magnitude(sum), common));
+    int64_t denumerator = 0;
+    if (__builtin_mul_overflow(small_denumerator / common, denum / rest, &denumerator)) {
+      return false;
+    }
+    small_numerator = sum / rest;
+    small_denumerator = denumerator;
+    return true;
+  }
+
+  // *this *= numer / denum для коротких несократимых дробей, denum > 0, с перекрёстным сокращением
+  bool mulSmall(int64_t numer, int64_t denum) {
+    if (small_numerator == 0 || numer == 0) {
+      small_numerator = 0;
+      small_denumerator = 1;
+      return true;
+    }
+    int64_t first = static_cast<int64_t>(binaryGcd(magnitude(small_numerator), denum));
+    int64_t second = static_cast<int64_t>(binaryGcd(magnitude(numer), small_denumerator));
+    int64_t numerator = 0;
+    int64_t denumerator = 0;
+    if (__builtin_mul_overflow(small_numerator / first, numer / second, &numerator) ||
+        __builtin_mul_overflow(small_denumerator / second, denum / first, &denumerator) || numerator == INT64_MIN) {
+      return false;
+    }
+    small_numerator = numerator;
+    small_denumerator = denumerator;
+    return true;
+  }
+
+  // длинная форма для операции, которая не уместилась; other может совпадать с *this
+  Rational& promote() {
+    if (!big) {
+      big = std::make_unique<Rational>(toRational(small_numerator, small_denumerator));
+    }
+    return *big;
+  }
+
+  // после длинной операции дробь возвращается в короткую форму, если может
+  HybridRational& settle() {
+    Rational value = std::move(*big);
+    setRational(std::move(value));
+    return *this;
+  }
+
+  HybridRational& operator+=(const HybridRational& other) {
+    if (!big && !other.big && addSmall(other.small_numerator, other.small_denumerator)) {
+      return *this;
+    }
+    Rational& value = promote();
+    value += (other.big ? *other.big : other.toRational());
+    return settle();
+  }
+
+  HybridRational& operator-=(const HybridRational& other) {
+    if (!big && !other.big && addSmall(-other.small_numerator, other.small_denumerator)) {
+      return *this;
+    }
+    Rational& value = promote();
+    value -= (other.big ? *other.big : other.toRational());
+    return settle();
+  }
+
+  HybridRational& operator*=(const HybridRational& other) {
+    if (!big && !other.big && mulSmall(other.small_numerator, other.small_denumerator)) {
+      return *this;
+    }
+    Rational& value = promote();
+    value *= (other.big ? *other.big : other.toRational());
+    return settle();
+  }
+
+  // деление - умножение на перевёрнутую дробь, знак делителя переносится в числитель
+  HybridRational& operator/=(const HybridRational& other) {
+    assert(other.big || other.small_numerator != 0);
+    if (!big && !other.big) {
+      bool negative = (other.small_numerator < 0);
+      int64_t numer = (negative ? -other.small_denumerator : other.small_denumerator);
+      int64_t denum = (negative ? -other.small_numerator : other.small_numerator);
+      if (mulSmall(numer, denum)) {
+        return *this;
+      }
+    }
+    Rational& value = promote();
+    value /= (other.big ? *other.big : other.toRational());
+    return settle();
+  }
+
+  HybridRational operator+(const HybridRational& other) const& {
+    HybridRational copy = *this;
+    copy += other;
+    return copy;
+  }
+
+  HybridRational operator+(const HybridRational& other) && {
+    *this += other;
+    return std::move(*this);
+  }
+
+  HybridRational operator-(const HybridRational& other) const& {
+    HybridRational copy = *this;
+    copy -= other;
+    return copy;
+  }
+
+  HybridRational operator-(const HybridRational& other) && {
+    *this -= other;
+    return std::move(*this);
+  }
+
+  HybridRational operator*(const HybridRational& other) const& {
+    HybridRational copy = *this;
+    copy *= other;
+    return copy;
+  }
+
+  HybridRational operator*(const HybridRational& other) && {
+    *this *= other;
+    return std::move(*this);
+  }
+
+  HybridRational operator/(const HybridRational& other) const& {
+    HybridRational copy = *this;
+    copy /= other;
+    return copy;
+  }
+
+  HybridRational operator/(const HybridRational& other) && {
+    *this /= other;
+    return std::move(*this);
+  }
+
+  HybridRational operator-() const {
+    HybridRational copy = *this;
+    if (copy.big) {
+      copy.big->numerator.signum *= Sign::Negative;
+    } else {
+      copy.small_numerator = -copy.small_numerator;
+    }
+    return copy;
+  }
+
+  // короткие дроби сравниваются произведениями в 128 битах, они не переполняются;
+  // без 128-битных чисел - в 64 битах, пока произведения помещаются
+  bool operator<(const HybridRational& rhs) const {
+    if (!big && !rhs.big) {
+#ifdef __SIZEOF_INT128__
+      return static_cast<__int128>(small_numerator) * rhs.small_denumerator <
+             static_cast<__int128>(rhs.small_numerator) * small_denumerator;
+#else
+      int64_t left = 0;
+      int64_t right = 0;
+      if (!__builtin_mul_overflow(small_numerator, rhs.small_denumerator, &left) &&
+          !__builtin_mul_overflow(rhs.small_numerator, small_denumerator, &right)) {
+        return left < right;
+      }
+#endif
+    }
+    if (big && rhs.big) {
+      return *big < *rhs.big;
+    }
+    return toRational() < rhs.toRational();
+  }
+
+  bool operator>(const HybridRational& rhs) const { return rhs < *this; }
+
+  bool operator<=(const HybridRational& rhs) const { return !(rhs < *this); }
+
+  bool operator>=(const HybridRational& rhs) const { return !(*this < rhs); }
+
+  // обе формы несократимы, а одно число не бывает в двух формах
+  bool operator==(const HybridRational& rhs) const {
+    if (!big && !rhs.big) {
+      return small_numerator == rhs.small_numerator && small_denumerator == rhs.small_denumerator;
+    }
+    return big && rhs.big && big->numerator == rhs.big->numerator && big->denumerator == rhs.big->denumerator;
+  }
+
+  bool operator!=(const HybridRational& rhs) const { return !(*this == rhs); }
+
+  string toString() const {
+    if (big) {
+      return big->toString();
+    }
+    string ans = std::to_string(small_numerator);
+    if (small_denumerator != 1) {
+      ans += "/" + std::to_string(small_denumerator);
+    }
+    return ans;
+  }
+
+  string asDecimal(size_t precision = 0) const {
+    return toRational().asDecimal(precision);
+  }
+
+  // частное двух точно представимых double округляется верно одним делением
+  double toDouble() const {
+    const int64_t kExact = int64_t(1) << 53;
+    if (!big && -kExact <= small_numerator && small_numerator <= kExact && small_denumerator <= kExact) {
+      return static_cast<double>(small_numerator) / static_cast<double>(small_denumerator);
+    }
+    return big ? big->toDouble() : toRational().toDouble();
+  }
+
+  explicit operator double() const {
+    return toDouble();
+  }
+};
+
+ostream& operator<<(ostream& output, const HybridRational& rational) {
+  return output << rational.toString();
+}
+
+// двоичный формат BigInteger и Rational: заголовок из kBinaryFormatMagic и байта версии, дальше
+// значения подряд. BigInteger - varint (число 64-битных слов << 1 | знак минус), за ним единственное
+// слово как varint или все слова по 8 байт little-endian; ноль - одна метка 0. Rational - несократимые
+// числитель и знаменатель. Ошибки не бросаются: читатель запоминает первую и дальше ничего не читает, как поток
+const char kBinaryFormatMagic[4] = {'B', 'i', 'g', 'I'};
+const uint8_t kBinaryFormatVersion = 1;
+// формат не зависит от ширины цифры: 32-битные цифры пишутся парами, старшее слово дополняется нулями
+const size_t kWordLimbs = 8 / sizeof(BigInteger::Limb);
+
+// цифры в порядке little-endian независимо от порядка байт машины
+void storeLimbs(uint8_t* out, const BigInteger::Limb* limbs, size_t count) {
+  if constexpr (std::endian::native == std::endian::little) {
+    std::memcpy(out, limbs, count * sizeof(BigInteger::Limb));
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      for (size_t byte = 0; byte < sizeof(BigInteger::Limb); byte++) {
+        out[i * sizeof(BigInteger::Limb) + byte] = static_cast<uint8_t>(limbs[i] >> (8 * byte));
+      }
+    }
+  }
+}
+
+// обратное к storeLimbs на месте: limbs уже содержат байты из файла
+void loadLimbs(BigInteger::Limb* limbs, size_t count) {
+  if constexpr (std::endian::native != std::endian::little) {
+    for (size_t i = 0; i < count; i++) {
+      uint8_t bytes[sizeof(BigInteger::Limb)];
+      std::memcpy(bytes, limbs + i, sizeof(bytes));
+      BigInteger::Limb value = 0;
+      for (size_t byte = sizeof(bytes); byte-- > 0;) {
+        value = (value << 8) | bytes[byte];
+      }
+      limbs[i] = value;
+    }
+  }
+}
+
+// запись в буфер buffer; с потоком буфер сбрасывается в него порциями по kFlushSize и в деструкторе
+struct BinaryWriter {
+  static const size_t kFlushSize = 1 << 16;
+
+  vector<uint8_t> buffer;
+  ostream* output = nullptr;
+
+  BinaryWriter() {
+    writeHeader();
+  }
+
+  explicit BinaryWriter(ostream& output) : output(&output) {
+    writeHeader();
+  }
+
+  BinaryWriter(const BinaryWriter&) = delete;
+  BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+  ~BinaryWriter() {
+    flush();
+  }
+
+  void writeHeader() {
+    buffer.insert(buffer.end(), kBinaryFormatMagic, kBinaryFormatMagic + sizeof(kBinaryFormatMagic));
+    buffer.push_back(kBinaryFormatVersion);
+  }
+
+  void writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+      buffer.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    buffer.push_back(static_cast<uint8_t>(value));
+  }
+
+  BinaryWriter& write(const BigInteger& value) {
+    size_t count = value.number.size();
+    size_t words = (count + kWordLimbs - 1) / kWordLimbs;
+    writeVarint((static_cast<uint64_t>(words) << 1) | (value.signum == Sign::Negative ? 1 : 0));
+    if (words == 1) {
+      writeVarint(value.magnitudeWord());
+    } else if (words > 1) {
+      size_t offset = buffer.size();
+      buffer.resize(offset + words * 8, 0);
+      storeLimbs(buffer.data() + offset, value.number.data(), count);
+    }
+    if (output != nullptr && buffer.size() >= kFlushSize) {
+      flush();
+    }
+    return *this;
+  }
+
+  BinaryWriter& write(const Rational& value) {
+    if (!value.reduced) {
+      Rational copy = value;
+      return write(copy.reduce());
+    }
+    return write(value.numerator).write(value.denumerator);
+  }
+
+  void flush() {
+    if (output != nullptr && !buffer.empty()) {
+      output->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+      buffer.clear();
+    }
+  }
+};
+
+// чтение из памяти (например, из отображённого в память файла: данные не копируются, цифры сразу
+// пишутся в целевой BigInteger, переиспользуя его память) или из потока через буфер
+struct BinaryReader {
+  static const size_t kChunkSize = 1 << 16;
+
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  size_t pos = 0;
+  istream* input = nullptr;
+  vector<uint8_t> storage;
+  bool failed = false;
+
+  BinaryReader(const uint8_t* data, size_t size) : data(data), size(size) {
+    readHeader();
+  }
+
+  explicit BinaryReader(const vector<uint8_t>& buffer) : BinaryReader(buffer.data(), buffer.size()) {}
+
+  explicit BinaryReader(istream& input) : input(&input) {
+    readHeader();
+  }
+
+  bool good() const {
+    return !failed;
+  }
+
+  explicit operator bool() const {
+    return good();
+  }
+
+  // в буфере не меньше count непрочитанных байт; из потока дочитывается недостающее
+  bool available(size_t count) {
+    if (size - pos >= count) {
+      return true;
+    }
+    if (input == nullptr) {
+      return false;
+    }
+    size_t rest = size - pos;
+    std::copy(storage.begin() + pos, storage.begin() + size, storage.begin());
+    storage.resize(count > kChunkSize ? count : kChunkSize);
+    input->read(reinterpret_cast<char*>(storage.data() + rest), storage.size() - rest);
+    data = storage.data();
+    size = rest + input->gcount();
+    pos = 0;
+    return size >= count;
+  }
+
+  // count байт в out: из буфера, а из потока остаток читается сразу в out
+  bool readBytes(uint8_t* out, size_t count) {
+    size_t ready = std::min(count, size - pos);
+    std::copy(data + pos, data + pos + ready, out);
+    pos += ready;
+    if (ready == count) {
+      return true;
+    }
+    if (input == nullptr) {
+      return false;
+    }
+    input->read(reinterpret_cast<char*>(out + ready), count - ready);
+    return static_cast<size_t>(input->gcount()) == count - ready;
+  }
+
+  bool fail() {
+    failed = true;
+    return false;
+  }
+
+  bool readHeader() {
+    if (!available(sizeof(kBinaryFormatMagic) + 1) ||
+        !std::equal(kBinaryFormatMagic, kBinaryFormatMagic + sizeof(kBinaryFormatMagic), data + pos) ||
+        data[pos + sizeof(kBinaryFormatMagic)] != kBinaryFormatVersion) {
+      return fail();
+    }
+    pos += sizeof(kBinaryFormatMagic) + 1;
+    return true;
+  }
+
+  bool readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (!available(1)) {
+        return fail();
+      }
+      uint8_t byte = data[pos++];
+      if (shift == 63 && byte > 1) {
+        return fail();
+      }
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return fail();
+  }
+
+  // значение читается только в каноничной записи: без ведущих нулевых цифр и без минус нуля
+  bool read(BigInteger& value) {
+    uint64_t tag = 0;
+    if (failed || !readVarint(tag)) {
+      return fail();
+    }
+    uint64_t count = tag >> 1;
+    Sign sign = ((tag & 1) != 0 ? Sign::Negative : Sign::Positive);
+    if (count == 0) {
+      if (sign == Sign::Negative) {
+        return fail();
+      }
+      value.toNull();
+      return true;
+    }
+    if (count == 1) {
+      uint64_t word = 0;
+      if (!readVarint(word) || word == 0) {
+        return fail();
+      }
+      value.setMagnitude(word);
+    } else {
+      // count * 8 байт не должно переполнять size_t; из памяти слов не может быть больше, чем осталось байт
+      if (count > SIZE_MAX / 8 || (input == nullptr && count > (size - pos) / 8)) {
+        return fail();
+      }
+      size_t limbs = static_cast<size_t>(count) * kWordLimbs;
+      // из потока длину проверить нечем: читаем порциями по kChunkSize байт, и память растёт вместе с данными
+      size_t step = (input == nullptr ? limbs : kChunkSize / sizeof(BigInteger::Limb));
+      value.number.clear();
+      for (size_t done = 0; done < limbs;) {
+        size_t part = (limbs - done < step ? limbs - done : step);
+        if (done + part > value.number.capacity()) {
+          size_t grown = 2 * value.number.capacity();
+          value.number.reserve(grown > done + part && grown < limbs ? grown : done + part);
+        }
+        value.number.resize(done + part);
+        if (!readBytes(reinterpret_cast<uint8_t*>(value.number.data() + done), part * sizeof(BigInteger::Limb))) {
+          value.toNull();
+          return fail();
+        }
+        done += part;
+      }
+      loadLimbs(value.number.data(), limbs);
+      while (!value.number.empty() && value.number.back() == 0) {
+        value.number.pop_back();
+      }
+      // старшее слово не нулевое
+      if (value.number.size() <= (count - 1) * kWordLimbs) {
+        value.toNull();
+        return fail();
+      }
+    }
+    value.signum = sign;
+    return true;
+  }
+
+  // дробь читается только несократимой и с положительным знаменателем: такой её пишет BinaryWriter,
+  // а флаг reduced для чужих байт без проверки ставить нельзя; при ошибке value = 0
+  bool read(Rational& value) {
+    if (!read(value.numerator) || !read(value.denumerator) || value.denumerator.signum != Sign::Positive ||
+        gcd(value.numerator, value.denumerator) != 1) {
+      value = Rational();
+      return fail();
+    }
+    value.reduced = true;
+    value.reduced_limbs = value.denumerator.number.size();
+    return true;
+  }
+};
+
 /*
 В общем ок, оставшиеся замечания:
 86: - отступ
@@ -763,4 +4267,6 @@ istream& operator>>(istream& input, Rational& rational) {
 
 Из-за того, что ты вызываешь -= из += и наоборот, у тебя происходит много лишних копий num. Лишние вызовы обычно и являются узким местом всех программ на C++, поэтому в данном случае это надо пофиксить (В твоей реализации, на самом деле менять num не надо, можно обойтись сменой знака у главного числа и вообще не копировать num)
 
- */
\ No newline at end of file
+ */
+
+#endif //CPPTASKS__BIGINTEGER_H_
@@ -0,0 +1,254 @@
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "biginteger.h"
+
+// замеры, по которым выбраны пороги и режимы в biginteger.h:
+//   g++ -O2 -std=c++20 biginteger_bench.cpp -o biginteger_bench && ./biginteger_bench [раздел...]
+// без аргументов выполняются все разделы; результаты - наносекунды на вызов (меньше - лучше)
+
+std::mt19937_64 rng(2024);
+
+// время одного вызова task в наносекундах: вызовы повторяются, пока серия не займёт kMinTime
+template <typename Task>
+double measureOnce(Task task) {
+  using Clock = std::chrono::steady_clock;
+  const std::chrono::duration<double> kMinTime(0.01);
+  for (size_t repeats = 1;; repeats *= 2) {
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < repeats; i++) {
+      task();
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    if (elapsed >= kMinTime) {
+      return elapsed.count() * 1e9 / repeats;
+    }
+  }
+}
+
+// лучшее из kRuns серий: шум соседних процессов только замедляет, поэтому минимум устойчивее среднего
+const int kRuns = 7;
+
+template <typename Task>
+double measure(Task task) {
+  double best = measureOnce(task);
+  for (int run = 1; run < kRuns; run++) {
+    best = std::min(best, measureOnce(task));
+  }
+  return best;
+}
+
+template <typename Integer>
+std::vector<typename Integer::Limb> random_limbs(size_t len) {
+  std::vector<typename Integer::Limb> limbs(len);
+  for (auto& limb : limbs) {
+    limb = static_cast<typename Integer::Limb>(rng());
+  }
+  limbs.back() |= 1;
+  return limbs;
+}
+
+// addLimbs и subLimbs скалярным циклом против AVX2-ядер на переносах lookaheadCarries, вызванных напрямую,
+// чтобы было видно и длины ниже kSimdThreshold
+void bench_carries() {
+#ifdef BIGINTEGER_AVX2
+  using Integer = BasicBigInteger<Limbs64>;
+  if (!Integer::hasAvx2()) {
+    std::cout << "carries: no avx2" << std::endl;
+    return;
+  }
+  std::cout << "carries: len, add scalar, add avx2, sub scalar, sub avx2" << std::endl;
+  Integer::simdAdditions() = false;
+  for (size_t len : {4, 8, 12, 16, 24, 32, 64, 256, 1024, 4096, 65536}) {
+    std::vector<Integer::Limb> a = random_limbs<Integer>(len);
+    std::vector<Integer::Limb> b = random_limbs<Integer>(len);
+    std::vector<Integer::Limb> res(len);
+    double times[4] = {
+        measure([&] { Integer::addLimbs(res.data(), a.data(), len, b.data(), len); }),
+        measure([&] { Integer::addLimbsAvx2(res.data(), a.data(), b.data(), len); }),
+        measure([&] { Integer::subLimbs(res.data(), a.data(), len, b.data(), len); }),
+        measure([&] { Integer::subLimbsAvx2(res.data(), a.data(), b.data(), len); }),
+    };
+    std::cout << std::setw(6) << len;
+    for (double time : times) {
+      std::cout << std::setw(12) << std::fixed << std::setprecision(1) << time;
+    }
+    std::cout << std::endl;
+  }
+  Integer::simdAdditions() = true;
+#else
+  std::cout << "carries: no avx2" << std::endl;
+#endif
+}
+
+// цена parallelFor на пуле против запуска новых std::thread на каждый вызов и NTT на длинах около
+// parallelThreshold() в одном потоке и в multiplicationThreads(); на одном ядре многопоточное NTT
+// выигрыша не даст, тогда важна только первая таблица
+void bench_threads() {
+  using Integer = BasicBigInteger<Limbs64>;
+  std::cout << "threads: workers, parallelFor (pool), std::thread spawn and join" << std::endl;
+  for (size_t threads : {2, 4, 8, 16}) {
+    double pool = measure([threads] { Integer::parallelFor(threads, threads, [](size_t, size_t) {}); });
+    double spawn = measure([threads] {
+      vector<std::thread> workers;
+      for (size_t t = 1; t < threads; t++) {
+        workers.emplace_back([] {});
+      }
+      for (std::thread& worker : workers) {
+        worker.join();
+      }
+    });
+    std::cout << std::setw(6) << threads << std::setw(12) << std::fixed << std::setprecision(1) << pool
+              << std::setw(12) << spawn << std::endl;
+  }
+  size_t threads = Integer::multiplicationThreads();
+  std::cout << "threads: len, ntt 1 thread, ntt " << threads << " threads (" << std::thread::hardware_concurrency()
+            << " cores)" << std::endl;
+  for (size_t len : {5000, 10000, 20000, 40000, 100000}) {
+    std::vector<Integer::Limb> a = random_limbs<Integer>(len);
+    std::vector<Integer::Limb> b = random_limbs<Integer>(len);
+    std::vector<Integer::Limb> res(2 * len);
+    double serial = measure([&] { Integer::mulNtt(res.data(), a.data(), len, b.data(), len, 1); });
+    double parallel = measure([&] { Integer::mulNtt(res.data(), a.data(), len, b.data(), len, threads); });
+    std::cout << std::setw(6) << len << std::setw(12) << std::fixed << std::setprecision(0) << serial
+              << std::setw(12) << parallel << std::endl;
+  }
+}
+
+// время двух алгоритмов умножения на одинаковых множителях длины len; first и second получают
+// (res, a, b, len), в конце - первая длина, начиная с которой second не медленнее first
+template <typename Integer, typename First, typename Second>
+void sweep(const std::string& name, const std::vector<size_t>& lengths, First first, Second second) {
+  std::cout << name << ": len, first, second, second / first" << std::endl;
+  size_t crossover = 0;
+  for (size_t len : lengths) {
+    std::vector<typename Integer::Limb> a = random_limbs<Integer>(len);
+    std::vector<typename Integer::Limb> b = random_limbs<Integer>(len);
+    std::vector<typename Integer::Limb> res(2 * len + 1);
+    // серии двух алгоритмов чередуются, чтобы медленный период машины задел оба
+    double first_time = 0;
+    double second_time = 0;
+    for (int run = 0; run < kRuns; run++) {
+      double first_run = measureOnce([&] { first(res.data(), a.data(), b.data(), len); });
+      double second_run = measureOnce([&] { second(res.data(), a.data(), b.data(), len); });
+      first_time = (run == 0 ? first_run : std::min(first_time, first_run));
+      second_time = (run == 0 ? second_run : std::min(second_time, second_run));
+    }
+    if (second_time > first_time) {
+      crossover = 0;
+    } else if (crossover == 0) {
+      crossover = len;
+    }
+    std::cout << std::setw(6) << len << std::setw(14) << std::fixed << std::setprecision(0) << first_time
+              << std::setw(14) << second_time << std::setw(8) << std::setprecision(2) << second_time / first_time
+              << std::endl;
+  }
+  std::cout << name << ": crossover " << crossover << std::endl;
+}
+
+// пороги kKaratsubaThreshold, kKaratsubaSquareThreshold, kToom3Threshold и kNttThreshold: каждый алгоритм
+// против предыдущего на верхнем уровне (дальше рекурсия идёт как обычно), NTT в одном потоке
+template <typename Integer>
+void bench_thresholds(const std::string& policy) {
+  using Limb = typename Integer::Limb;
+  auto schoolbook = [](Limb* res, const Limb* a, const Limb* b, size_t len) {
+    Integer::mulSchoolbook(res, a, len, b, len);
+  };
+  auto karatsuba = [](Limb* res, const Limb* a, const Limb* b, size_t len) {
+    Integer::mulKaratsuba(res, a, b, len, Integer::karatsubaBuffer(len));
+  };
+  auto toom3 = [](Limb* res, const Limb* a, const Limb* b, size_t len) {
+    Integer::mulToom3(res, a, len, b, len);
+  };
+  auto ntt = [](Limb* res, const Limb* a, const Limb* b, size_t len) {
+    Integer::mulNtt(res, a, len, b, len, 1);
+  };
+  auto square_schoolbook = [](Limb* res, const Limb* a, const Limb*, size_t len) {
+    Integer::sqrSchoolbook(res, a, len);
+  };
+  auto square_karatsuba = [](Limb* res, const Limb* a, const Limb*, size_t len) {
+    Integer::sqrKaratsuba(res, a, len, Integer::karatsubaBuffer(len));
+  };
+  auto square_toom3 = [](Limb* res, const Limb* a, const Limb*, size_t len) {
+    Integer::mulToom3(res, a, len, a, len);
+  };
+  auto square_ntt = [](Limb* res, const Limb* a, const Limb*, size_t len) {
+    Integer::mulNtt(res, a, len, a, len, 1);
+  };
+  sweep<Integer>(policy + " karatsuba", {8, 12, 16, 20, 24, 28, 32, 40, 48, 64}, schoolbook, karatsuba);
+  sweep<Integer>(policy + " karatsuba square", {16, 24, 32, 40, 48, 56, 64, 80, 96}, square_schoolbook,
+                 square_karatsuba);
+  sweep<Integer>(policy + " toom3", {100, 150, 200, 250, 300, 350, 400, 500, 600, 800}, karatsuba, toom3);
+  sweep<Integer>(policy + " toom3 square", {100, 150, 200, 250, 300, 350, 400, 500, 600, 800}, square_karatsuba,
+                 square_toom3);
+  std::vector<size_t> ntt_lengths = {1000, 2000, 3000, 4000, 6000, 8000, 12000, 16000, 24000, 28000, 32000, 40000};
+  sweep<Integer>(policy + " ntt", ntt_lengths, toom3, ntt);
+  sweep<Integer>(policy + " ntt square", ntt_lengths, square_toom3, square_ntt);
+}
+
+// операции одной политики над числами из decimal_digits десятичных знаков: делимое вдвое длиннее делителя
+template <typename Integer>
+std::vector<double> policy_times(const std::string& first, const std::string& second) {
+  Integer a(first);
+  Integer b(second);
+  Integer dividend = a * a;
+  return {
+      measure([&] { return a * b; }),
+      measure([&] { return dividend / b; }),
+      measure([&] { return a.toString(); }),
+      measure([&] { return gcd(a, b); }),
+  };
+}
+
+// Limbs64 против Limbs32 на одних и тех же значениях (выбор BIGINTEGER_LIMB_POLICY по умолчанию);
+// в строке - время Limbs64 и отношение Limbs32 / Limbs64 для умножения, деления, вывода и НОД
+void bench_policy() {
+#ifdef __SIZEOF_INT128__
+  std::cout << "policy: digits, mul 64, ratio, div 64, ratio, toString 64, ratio, gcd 64, ratio" << std::endl;
+  for (size_t digits : {100, 1000, 10000, 100000}) {
+    std::string first(digits, '0');
+    std::string second(digits, '0');
+    for (size_t i = 0; i < digits; i++) {
+      first[i] = static_cast<char>('0' + rng() % 10);
+      second[i] = static_cast<char>('0' + rng() % 10);
+    }
+    first[0] = second[0] = '7';
+    std::vector<double> wide = policy_times<BasicBigInteger<Limbs64>>(first, second);
+    std::vector<double> narrow = policy_times<BasicBigInteger<Limbs32>>(first, second);
+    std::cout << std::setw(7) << digits;
+    for (size_t i = 0; i < wide.size(); i++) {
+      std::cout << std::setw(12) << std::fixed << std::setprecision(0) << wide[i] << std::setw(6)
+                << std::setprecision(2) << narrow[i] / wide[i];
+    }
+    std::cout << std::endl;
+  }
+#else
+  std::cout << "policy: no Limbs64" << std::endl;
+#endif
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> sections(argv + 1, argv + argc);
+  auto selected = [&sections](const std::string& name) {
+    return sections.empty() || std::find(sections.begin(), sections.end(), name) != sections.end();
+  };
+  if (selected("carries")) {
+    bench_carries();
+  }
+  if (selected("thresholds")) {
+    bench_thresholds<BasicBigInteger<Limbs64>>("Limbs64");
+    bench_thresholds<BasicBigInteger<Limbs32>>("Limbs32");
+  }
+  if (selected("threads")) {
+    bench_threads();
+  }
+  if (selected("policy")) {
+    bench_policy();
+  }
+}
@@ -0,0 +1,1233 @@
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cassert>
+#include <limits>
+#include <cmath>
+#include <bit>
+
+#include "biginteger.h"
+
+std::mt19937_64 rng(2024);
+
+// случайное число ровно из len цифр (старшая не нулевая) со случайным знаком
+template <typename Integer>
+Integer random_integer(size_t len, bool allow_negative = true) {
+  std::vector<typename Integer::Limb> limbs(len);
+  for (auto& limb : limbs) {
+    limb = static_cast<typename Integer::Limb>(rng());
+  }
+  if (len > 0 && limbs.back() == 0) {
+    limbs.back() = 1;
+  }
+  Integer value = Integer::fromLimbs(limbs.data(), len);
+  if (allow_negative && rng() % 2 == 0) {
+    value = -value;
+  }
+  return value;
+}
+
+// произведение столбиком, без Карацубы, Тума-Кука и NTT
+template <typename Integer>
+Integer schoolbook_product(const Integer& a, const Integer& b) {
+  if (a == 0 || b == 0) {
+    return 0;
+  }
+  std::vector<typename Integer::Limb> res(a.number.size() + b.number.size());
+  Integer::mulSchoolbook(res.data(), a.number.data(), a.number.size(), b.number.data(), b.number.size());
+  Integer product = Integer::fromLimbs(res.data(), res.size());
+  return (a < 0) != (b < 0) ? -product : product;
+}
+
+// произведение по Туму-Куку на верхнем уровне: куски короче kNttThreshold, так что NTT не участвует
+template <typename Integer>
+Integer toom3_product(const Integer& a, const Integer& b) {
+  if (a == 0 || b == 0) {
+    return 0;
+  }
+  std::vector<typename Integer::Limb> res(a.number.size() + b.number.size());
+  Integer::mulToom3(res.data(), a.number.data(), a.number.size(), b.number.data(), b.number.size());
+  Integer product = Integer::fromLimbs(res.data(), res.size());
+  return (a < 0) != (b < 0) ? -product : product;
+}
+
+template <typename Integer>
+void test_karatsuba() {
+  size_t threshold = Integer::kKaratsubaThreshold;
+  for (size_t len : {threshold - 1, threshold, threshold + 1, 2 * threshold + 1}) {
+    Integer a = random_integer<Integer>(len);
+    Integer b = random_integer<Integer>(len);
+    assert(a * b == schoolbook_product(a, b));
+    // множители разной длины: длинный режется на куски длины короткого
+    Integer c = random_integer<Integer>(3 * len + 7);
+    assert(c * b == schoolbook_product(c, b));
+    assert(b * c == c * b);
+  }
+  for (int i = 0; i < 100; i++) {
+    Integer a = random_integer<Integer>(rng() % (4 * threshold) + 1);
+    Integer b = random_integer<Integer>(rng() % (4 * threshold) + 1);
+    assert(a * b == schoolbook_product(a, b));
+  }
+  Integer a = random_integer<Integer>(threshold + 3);
+  assert(a * 0 == 0 && a * 1 == a && a * -1 == -a);
+}
+
+template <typename Integer>
+void test_ntt() {
+  size_t threshold = Integer::kNttThreshold;
+  for (size_t len : {threshold - 1, threshold, threshold + 1}) {
+    Integer a = random_integer<Integer>(len);
+    Integer b = random_integer<Integer>(len);
+    assert(a * b == toom3_product(a, b));
+  }
+  // множители разной длины
+  Integer a = random_integer<Integer>(3 * threshold);
+  Integer b = random_integer<Integer>(threshold + 5);
+  assert(a * b == toom3_product(a, b));
+  // максимальные цифры дают максимальные свёртки, на которых CRT трёх модулей ещё точен
+  std::vector<typename Integer::Limb> ones(threshold + 1, static_cast<typename Integer::Limb>(-1));
+  Integer max_limbs = Integer::fromLimbs(ones.data(), ones.size());
+  assert(max_limbs * max_limbs == toom3_product(max_limbs, max_limbs));
+}
+
+template <typename Integer>
+void check_division(const Integer& a, const Integer& b) {
+  Integer quotient = a / b;
+  Integer remainder = a % b;
+  assert(a == quotient * b + remainder);
+  Integer abs_b = (b < 0 ? -b : b);
+  assert(remainder < abs_b && -remainder < abs_b);
+  assert(remainder == 0 || (remainder < 0) == (a < 0));
+}
+
+template <typename Integer>
+void test_long_division() {
+  for (int i = 0; i < 300; i++) {
+    Integer a = random_integer<Integer>(rng() % 40);
+    Integer b = random_integer<Integer>(rng() % 20 + 1);
+    check_division(a, b);
+  }
+  // B^n - 1 на B^k - 1 и на B^k + 1: оценка цифры частного ошибается и исправляется
+  using Limb = typename Integer::Limb;
+  for (size_t n : {2, 5, 9}) {
+    for (size_t k : {1, 2, 4}) {
+      std::vector<Limb> ones(n, static_cast<Limb>(-1));
+      std::vector<Limb> divisor(k, static_cast<Limb>(-1));
+      Integer a = Integer::fromLimbs(ones.data(), n);
+      Integer b = Integer::fromLimbs(divisor.data(), k);
+      check_division(a, b);
+      check_division(a, b + 2);
+      check_division(a, -b);
+    }
+  }
+  Integer a = random_integer<Integer>(10);
+  Integer b = random_integer<Integer>(4);
+  assert(a / a == 1 && a % a == 0 && b / a == 0 && b % a == b);
+  Integer quotient;
+  Integer remainder = b;
+  Integer::divMod(a, remainder, quotient, remainder);
+  assert(quotient == a / b && remainder == a % b);
+  assert(Integer(-7) / Integer(2) == -3 && Integer(-7) % Integer(2) == -1);
+  assert(Integer(7) / Integer(-2) == -3 && Integer(7) % Integer(-2) == 1);
+}
+
+template <typename Integer>
+void test_newton_division() {
+  size_t threshold = Integer::kNewtonDivisionThreshold;
+  for (size_t len : {threshold - 1, threshold, threshold + 1, 3 * threshold}) {
+    Integer b = random_integer<Integer>(len);
+    check_division(random_integer<Integer>(2 * len + 3), b);
+    check_division(random_integer<Integer>(len + threshold - 1), b);
+    check_division(random_integer<Integer>(len + threshold + 1), b);
+    check_division(random_integer<Integer>(len), b);
+    PrecomputedDivisor divisor(b);
+    Integer a = random_integer<Integer>(2 * len + 7);
+    Integer quotient;
+    Integer remainder;
+    divisor.divMod(a, quotient, remainder);
+    assert(quotient == a / b && remainder == a % b);
+  }
+  // делимое - точное кратное: остаток ровно 0, а не делитель
+  Integer b = random_integer<Integer>(threshold + 10);
+  Integer q = random_integer<Integer>(threshold + 20);
+  assert((b * q) / b == q && (b * q) % b == 0);
+  check_division(b * q - 1, b);
+  check_division(b * q + b - 1, b);
+}
+
+// десятичная запись из digits случайных цифр без ведущих нулей
+std::string random_decimal(size_t digits) {
+  std::string str(1, static_cast<char>('1' + rng() % 9));
+  for (size_t i = 1; i < digits; i++) {
+    str += static_cast<char>('0' + rng() % 10);
+  }
+  return str;
+}
+
+template <typename Integer>
+void test_decimal_conversion() {
+  size_t chunk_threshold = Integer::kConversionThreshold;
+  for (size_t chunks : {size_t(1), chunk_threshold - 1, chunk_threshold, chunk_threshold + 1, 2 * chunk_threshold + 1,
+                        size_t(1000)}) {
+    for (size_t digits : {Integer::kChunkDigits * chunks - 1, Integer::kChunkDigits * chunks,
+                          Integer::kChunkDigits * chunks + 1}) {
+      std::string str = random_decimal(digits);
+      assert(Integer(str).toString() == str);
+      assert(Integer("-" + str).toString() == "-" + str);
+    }
+    Integer value = random_integer<Integer>(chunks);
+    assert(Integer(value.toString()) == value);
+  }
+  // блоки из одних нулей внутри числа и на краях дерева деления
+  std::string power = "1" + std::string(Integer::kChunkDigits * 64, '0');
+  assert(Integer(power).toString() == power);
+  assert((Integer(power) - 1).toString() == std::string(Integer::kChunkDigits * 64, '9'));
+  assert(Integer("000123").toString() == "123" && Integer("-0") == 0 && Integer("0").toString() == "0");
+  std::vector<uint32_t> chunks = Integer::toDecimalChunks(Integer(power));
+  assert(chunks.size() == 65 && chunks.back() == 1);
+  assert(Integer::fromDecimalChunks(chunks.data(), chunks.size()) == Integer(power));
+}
+
+template <typename Integer>
+void test_binary_limbs() {
+  using Limb = typename Integer::Limb;
+  Limb max_limb = static_cast<Limb>(-1);
+  Integer top = Integer::fromLimbs(&max_limb, 1);
+  // перенос и заём через границу цифры
+  Integer carried = top + 1;
+  assert(carried.number.size() == 2 && carried.number[0] == 0 && carried.number[1] == 1);
+  assert(carried - 1 == top && (carried - 1).number.size() == 1);
+  assert(top * top + 2 * top + 1 == carried * carried);
+  assert((carried * carried).number.size() == 3);
+  assert(Integer(-2147483647 - 1).toString() == "-2147483648");
+  assert(Integer(2147483647) + 1 == Integer("2147483648"));
+  // 2^64 и 2^64 - 1 десятично при любом размере цифры
+  Integer word_max("18446744073709551615");
+  assert(word_max.magnitudeWord() == UINT64_MAX && (word_max + 1).toString() == "18446744073709551616");
+  assert(word_max.number.size() == 64 / Integer::kLimbBits);
+  for (int i = 0; i < 100; i++) {
+    Integer a = random_integer<Integer>(rng() % 5 + 1);
+    Integer b = random_integer<Integer>(rng() % 5 + 1);
+    assert(Integer((a + b).toString()) == a + b && a + b - b == a);
+    assert(a.number.back() != 0);
+  }
+}
+
+template <typename Integer>
+void test_inline_storage() {
+  size_t inline_limbs = Integer::kInlineLimbs;
+  Integer small = random_integer<Integer>(inline_limbs);
+  Integer large = random_integer<Integer>(inline_limbs + 3);
+  assert(small.number.capacity() == inline_limbs);
+  Integer small_copy = small;
+  Integer large_copy = large;
+  // обмен и перемещение между встроенным буфером и кучей
+  small_copy.swap(large_copy);
+  assert(small_copy == large && large_copy == small);
+  small_copy.swap(large_copy);
+  Integer moved_small = std::move(small_copy);
+  Integer moved_large = std::move(large_copy);
+  assert(moved_small == small && moved_large == large);
+  moved_small = moved_large;
+  assert(moved_small == large);
+  moved_large = small;
+  assert(moved_large == small);
+  moved_large = std::move(moved_small);
+  assert(moved_large == large);
+  Integer& self = moved_large;
+  moved_large = self;
+  assert(moved_large == large);
+  // рост из встроенного буфера в кучу и обратно к маленькому значению
+  Integer value = small;
+  for (size_t i = 0; i < 3; i++) {
+    value *= large;
+  }
+  assert(value / large / large / large == small);
+  value -= value - 7;
+  assert(value == 7 && value.number.size() == 1);
+  std::vector<Integer> values(50, small);
+  values.push_back(large);
+  values.erase(values.begin());
+  assert(values.back() == large && values.front() == small);
+}
+
+template <typename Integer>
+void test_add_sub() {
+  for (int i = 0; i < 500; i++) {
+    int64_t x = static_cast<int32_t>(rng());
+    int64_t y = static_cast<int32_t>(rng());
+    Integer a(static_cast<int>(x));
+    a += Integer(static_cast<int>(y));
+    assert(a.toString() == std::to_string(x + y));
+    a -= Integer(static_cast<int>(y));
+    a -= Integer(static_cast<int>(y));
+    assert(a.toString() == std::to_string(x - y));
+  }
+  for (int i = 0; i < 300; i++) {
+    Integer a = random_integer<Integer>(rng() % 30);
+    Integer b = random_integer<Integer>(rng() % 30);
+    Integer c = random_integer<Integer>(rng() % 3 + 1);
+    Integer sum = a;
+    sum += b;
+    Integer difference = a;
+    difference -= b;
+    assert(sum - b == a && difference + b == a && sum + difference == a + a);
+    assert(sum * c == a * c + b * c);
+    // слагаемое совпадает с результатом
+    Integer doubled = a;
+    doubled += doubled;
+    assert(doubled == 2 * a);
+    doubled -= doubled;
+    assert(doubled == 0 && doubled.number.empty());
+  }
+  // смена знака и обнуление старших цифр
+  Integer a = random_integer<Integer>(6, false);
+  Integer b = a + 1;
+  Integer c = a;
+  c -= b;
+  assert(c == -1 && c.number.size() == 1);
+  c += b;
+  assert(c == a);
+  c += -a;
+  assert(c == 0);
+}
+
+template <typename Integer>
+void test_gcd() {
+  for (size_t len : {1, 2, 5, 40, 300}) {
+    Integer a = random_integer<Integer>(len);
+    Integer b = random_integer<Integer>(len / 2 + 1);
+    Integer c = random_integer<Integer>(len / 3 + 1, false);
+    Integer g = gcd(a, b);
+    assert(g > 0 && a % g == 0 && b % g == 0);
+    assert(gcd(a / g, b / g) == 1);
+    assert(gcd(a * c, b * c) == g * c);
+    assert(gcd(b, a) == g && gcd(-a, b) == g);
+    Integer x;
+    Integer y;
+    assert(gcdExtended(a, b, x, y) == g);
+    assert(a * x + b * y == g);
+  }
+  // соседние числа Фибоначчи - худший случай для алгоритма Евклида
+  Integer previous = 1;
+  Integer current = 1;
+  for (int i = 0; i < 1000; i++) {
+    previous += current;
+    previous.swap(current);
+  }
+  assert(gcd(current, previous) == 1 && gcd(current * 12, previous * 18) == 6);
+  assert(gcd(Integer(48), Integer(-18)) == 6 && gcd(Integer(17), Integer(17)) == 17);
+}
+
+void test_rational_normalization() {
+  BigInteger a = random_integer<BigInteger>(5);
+  BigInteger b = random_integer<BigInteger>(4);
+  BigInteger c = random_integer<BigInteger>(3);
+  BigInteger g = gcd(a, b);
+  Rational fraction(a * c, b * c);
+  fraction.reduce();
+  BigInteger expected_numerator = (b < 0 ? -a : a) / g;
+  BigInteger expected_denumerator = (b < 0 ? -b : b) / g;
+  assert(fraction.numerator == expected_numerator && fraction.denumerator == expected_denumerator);
+  assert(Rational(6, -4).numerator == -3 && Rational(6, -4).denumerator == 2);
+}
+
+// base^exp mod mod возведением в квадрат и умножением с остатком после каждого шага
+template <typename Integer>
+Integer reference_pow_mod(Integer base, Integer exp, const Integer& mod) {
+  Integer result = 1;
+  base %= mod;
+  while (exp > 0) {
+    if (exp % 2 == 1) {
+      result = result * base % mod;
+    }
+    base = base * base % mod;
+    exp /= 2;
+  }
+  result %= mod;
+  return result < 0 ? result + mod : result;
+}
+
+template <typename Integer>
+void test_pow_mod() {
+  for (size_t len : {1, 2, 3, 20, 45}) {
+    Integer base = random_integer<Integer>(len + 1);
+    Integer exp = random_integer<Integer>(rng() % 3 + 1, false);
+    // нечётный модуль идёт через Монтгомери, чётный - через обращённый делитель
+    Integer odd = random_integer<Integer>(len, false);
+    if (odd % 2 == 0) {
+      odd += 1;
+    }
+    Integer even = odd + 1;
+    assert(powMod(base, exp, odd) == reference_pow_mod(base, exp, odd));
+    assert(powMod(base, exp, even) == reference_pow_mod(base, exp, even));
+    assert(powMod(base, exp, -odd) == powMod(base, exp, odd));
+    assert(powMod(base, Integer(0), odd) == 1);
+    // один контекст Монтгомери на много возведений
+    MontgomeryContext context(odd);
+    Integer other = random_integer<Integer>(len, false);
+    assert(context.pow(base, exp) == powMod(base, exp, odd));
+    assert(context.pow(other, exp) == reference_pow_mod(other, exp, odd));
+  }
+  // малая теорема Ферма для простого 2^127 - 1
+  Integer prime("170141183460469231731687303715884105727");
+  Integer base = random_integer<Integer>(3, false);
+  assert(powMod(base, prime - 1, prime) == 1);
+  assert(powMod(Integer(5), Integer(3), Integer(1)) == 0 && powMod(Integer(-2), Integer(3), Integer(7)) == 6);
+}
+
+// сумма и разность с выключенным и включённым AVX2 совпадают
+template <typename Integer>
+void check_simd_paths(const Integer& a, const Integer& b) {
+  Integer::simdAdditions() = false;
+  Integer scalar_sum = a + b;
+  Integer scalar_difference = a - b;
+  Integer::simdAdditions() = true;
+  assert(a + b == scalar_sum && a - b == scalar_difference);
+}
+
+template <typename Integer>
+void test_simd_carries() {
+  using Limb = typename Integer::Limb;
+  size_t threshold = Integer::kSimdThreshold;
+  for (size_t len : {threshold - 1, threshold, threshold + 1, threshold + 3, 4 * threshold + 2, size_t(1000)}) {
+    for (int i = 0; i < 20; i++) {
+      check_simd_paths(random_integer<Integer>(len, false), random_integer<Integer>(len, false));
+      check_simd_paths(random_integer<Integer>(len + rng() % 5, false), random_integer<Integer>(len, false));
+    }
+    // цепочки переносов и заёмов через все дорожки: цифры kBase - 1 и 0 вперемешку с единицами
+    std::vector<Limb> ones(len, static_cast<Limb>(-1));
+    std::vector<Limb> pattern(len);
+    for (size_t i = 0; i < len; i++) {
+      pattern[i] = (rng() % 3 == 0 ? 1 : (rng() % 2 == 0 ? 0 : static_cast<Limb>(-1)));
+    }
+    pattern.back() = 1;
+    Integer all_ones = Integer::fromLimbs(ones.data(), len);
+    Integer mixed = Integer::fromLimbs(pattern.data(), len);
+    check_simd_paths(all_ones, Integer(1));
+    check_simd_paths(all_ones, all_ones);
+    check_simd_paths(all_ones, mixed);
+    check_simd_paths(mixed, all_ones);
+    check_simd_paths(all_ones + 1, all_ones);
+    check_simd_paths(mixed, mixed);
+  }
+#ifdef BIGINTEGER_AVX2
+  // маски переносов по всем сочетаниям gen, prop и входящего переноса против последовательного прохода
+  for (unsigned gen = 0; gen < 16; gen++) {
+    for (unsigned prop = 0; prop < 16; prop++) {
+      if ((gen & prop) != 0) {
+        continue;
+      }
+      for (unsigned carry_in = 0; carry_in < 2; carry_in++) {
+        unsigned expected = 0;
+        unsigned ripple = carry_in;
+        for (unsigned lane = 0; lane < 4; lane++) {
+          expected |= ripple << lane;
+          ripple = ((gen >> lane) & 1) | (((prop >> lane) & 1) & ripple);
+        }
+        unsigned carry = carry_in;
+        assert(Integer::lookaheadCarries(gen, prop, carry) == expected && carry == ripple);
+      }
+    }
+  }
+#endif
+}
+
+template <typename Integer>
+void test_parallel_multiplication() {
+  size_t threads = Integer::multiplicationThreads();
+  size_t threshold = Integer::parallelThreshold();
+  Integer a = random_integer<Integer>(Integer::kNttThreshold + 100);
+  Integer b = random_integer<Integer>(Integer::kNttThreshold + 50);
+  Integer::multiplicationThreads() = 1;
+  Integer serial = a * b;
+  Integer serial_square = a.square();
+  // потоков больше, чем ядер, и порог ниже длины множителей: куски NTT и сборки идут в WorkerPool
+  Integer::multiplicationThreads() = 5;
+  Integer::parallelThreshold() = Integer::kNttThreshold;
+  assert(a * b == serial && a.square() == serial_square);
+  assert(serial == toom3_product(a, b));
+  // parallelFor из нескольких потоков сразу делит один пул
+  std::vector<Integer> products(3);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < products.size(); i++) {
+    workers.emplace_back([&products, &a, &b, i] { products[i] = a * b; });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  for (const Integer& product : products) {
+    assert(product == serial);
+  }
+  Integer::multiplicationThreads() = threads;
+  Integer::parallelThreshold() = threshold;
+}
+
+// Тум-Кук и возведение в квадрат на границах своих порогов, в том числе множители разной длины
+template <typename Integer>
+void test_toom3_and_squares() {
+  size_t square_threshold = Integer::kKaratsubaSquareThreshold;
+  for (size_t len : {square_threshold - 1, square_threshold, square_threshold + 1, 3 * square_threshold + 1}) {
+    Integer a = random_integer<Integer>(len);
+    assert(a * a == schoolbook_product(a, a));
+    Integer copy = a;
+    assert(a * copy == a * a);
+  }
+  size_t threshold = Integer::kToom3Threshold;
+  for (size_t len : {threshold - 1, threshold, threshold + 1, 2 * threshold + 2}) {
+    Integer a = random_integer<Integer>(len);
+    Integer b = random_integer<Integer>(len);
+    assert(a * b == schoolbook_product(a, b));
+    assert(a * a == schoolbook_product(a, a));
+    assert(toom3_product(a, b) == a * b);
+    // куски Тума-Кука у короткого множителя частично пусты
+    Integer c = random_integer<Integer>(len / 2 + 1);
+    assert(toom3_product(a, c) == schoolbook_product(a, c));
+    assert(toom3_product(c, a) == schoolbook_product(a, c));
+  }
+}
+
+// C(n, k) по формуле C(n, i) = C(n, i - 1) * (n - i + 1) / i
+template <typename Integer>
+Integer reference_binomial(uint64_t n, uint64_t k) {
+  Integer result = 1;
+  for (uint64_t i = 1; i <= k; i++) {
+    result = result * Integer(std::to_string(n - i + 1)) / Integer(std::to_string(i));
+  }
+  return result;
+}
+
+template <typename Integer>
+void test_factorial_binomial() {
+  Integer expected = 1;
+  for (int n = 0; n <= 600; n++) {
+    if (n > 0) {
+      expected *= n;
+    }
+    if (n < 40 || n % 37 == 0) {
+      assert(Integer::factorial(n) == expected);
+    }
+  }
+  assert(Integer::factorial(20) == Integer("2432902008176640000"));
+  // k * log n < n - через произведение n - k + 1, ..., n, иначе - по показателям простых (Лежандр)
+  for (uint64_t n : {0, 1, 2, 10, 63, 64, 100, 1000}) {
+    for (uint64_t k : {uint64_t(0), uint64_t(1), uint64_t(2), uint64_t(5), n / 3, n / 2, n - 1, n}) {
+      if (k <= n) {
+        Integer value = Integer::binomial(n, k);
+        assert(value == reference_binomial<Integer>(n, k));
+        assert(value == Integer::binomial(n, n - k));
+      }
+    }
+  }
+  assert(Integer::binomial(5, 7) == 0);
+  assert(Integer::binomial(4000, 2000) == Integer::binomial(3999, 1999) + Integer::binomial(3999, 2000));
+  // n больше kBinomialSieveLimit: решето не строится даже при большом k
+  uint64_t n = Integer::kBinomialSieveLimit + 12345;
+  assert(Integer::binomial(n, 3) == reference_binomial<Integer>(n, 3));
+  assert(Integer::binomial(n, 200) == reference_binomial<Integer>(n, 200));
+  assert(Integer::binomial(n, n - 7) == reference_binomial<Integer>(n, 7));
+
+  std::vector<Integer> values;
+  Integer sequential = 1;
+  for (size_t i = 0; i < 200; i++) {
+    values.push_back(random_integer<Integer>(i % 7 + 1));
+    sequential *= values.back();
+  }
+  assert(Integer::product(values.begin(), values.end()) == sequential);
+  assert(Integer::product(values.begin(), values.begin() + 1) == values[0]);
+  assert(Integer::product(values.begin(), values.begin()) == 1);
+  std::vector<int> small = {3, -4, 5, 7};
+  assert(Integer::product(small.begin(), small.end()) == -420);
+}
+
+template <typename Integer>
+void test_roots() {
+  for (uint64_t k : {2, 3, 5, 6, 64}) {
+    for (size_t len : {1, 2, 7, 40}) {
+      Integer value = random_integer<Integer>(len, false);
+      Integer root = iroot(value, k);
+      assert(power(root, k) <= value && power(root + 1, k) > value);
+      // точные степени и соседние с ними числа
+      Integer exact = power(root + 1, k);
+      assert(iroot(exact, k) == root + 1 && iroot(exact - 1, k) == root && iroot(exact + 1, k) == root + 1);
+    }
+  }
+  Integer value = random_integer<Integer>(25, false);
+  Integer root = isqrt(value);
+  assert(root * root <= value && (root + 1) * (root + 1) > value);
+  assert(isqrt(Integer(0)) == 0 && isqrt(Integer(1)) == 1 && isqrt(Integer(99)) == 9 && isqrt(Integer(100)) == 10);
+  // корень нечётной степени из отрицательного числа округляется к нулю
+  assert(iroot(Integer(-28), 3) == -3 && iroot(Integer(-27), 3) == -3 && iroot(Integer(-26), 3) == -2);
+  assert(iroot(value, 1) == value);
+
+  Integer base = random_integer<Integer>(3, false);
+  if (isPerfectPower(base)) {
+    base += 1;
+  }
+  uint64_t exponent;
+  // составной показатель: x^6 находится как (x^3)^2 и (x^2)^3, ответ - наибольший показатель
+  for (uint64_t k : {2, 3, 6, 15, 64}) {
+    Integer exact = power(base, k);
+    assert(isPerfectPower(exact, root, exponent) && root == base && exponent == k);
+    // промах на единицу в обе стороны
+    assert(!isPerfectPower(exact + 1) && !isPerfectPower(exact - 1));
+  }
+  assert(isPerfectPower(-power(base, 15), root, exponent) && root == -base && exponent == 15);
+  assert(isPerfectPower(-power(base, 6), root, exponent) && root == -power(base, 2) && exponent == 3);
+  assert(!isPerfectPower(-power(base, 4)));
+  // корень меньше 2^32 находится плавающей оценкой
+  assert(isPerfectPower(power(Integer(3), 40), root, exponent) && root == 3 && exponent == 40);
+  assert(isPerfectPower(power(Integer(1000003), 7), root, exponent) && root == 1000003 && exponent == 7);
+  assert(!isPerfectPower(power(Integer(1000003), 7) + 2));
+  assert(!isPerfectPower(Integer(2)) && !isPerfectPower(Integer(-2)));
+  assert(isPerfectPower(Integer(0)) && isPerfectPower(Integer(1)) && isPerfectPower(Integer(-1), root, exponent));
+  assert(root == -1 && exponent == 3);
+}
+
+// операторы с временными операндами дают то же, что и с константными ссылками, в том числе когда
+// временный операнд и второй операнд - один и тот же объект
+template <typename Integer>
+void test_rvalue_operators() {
+  for (size_t len : {1, 3, 30, 400}) {
+    const Integer a = random_integer<Integer>(len);
+    const Integer b = random_integer<Integer>(len / 2 + 1);
+    Integer copy;
+    assert((copy = a, std::move(copy) + b) == a + b && (copy = b, a + std::move(copy)) == a + b);
+    assert((copy = a, std::move(copy) - b) == a - b && (copy = b, a - std::move(copy)) == a - b);
+    assert((copy = a, std::move(copy) * b) == a * b && (copy = b, a * std::move(copy)) == a * b);
+    assert((copy = a, std::move(copy) / b) == a / b && (copy = a, std::move(copy) % b) == a % b);
+    assert((copy = a, -std::move(copy)) == -a);
+    Integer left = a;
+    Integer right = b;
+    assert(std::move(left) * std::move(right) == a * b);
+    left = a;
+    right = b;
+    assert(std::move(left) - std::move(right) == a - b);
+    left = a;
+    right = b;
+    assert(std::move(left) + std::move(right) == a + b);
+    assert((copy = a, std::move(copy) * 7) == a * 7 && (copy = a, std::move(copy) - 5) == a - 5);
+    assert((copy = a, 3 * std::move(copy)) == a * 3 && (copy = a, 5 - std::move(copy)) == 5 - a);
+    assert((copy = a, 5 + std::move(copy)) == a + 5 && (copy = a, std::move(copy) / 3) == a / 3);
+
+    // временный левый операнд совпадает с правым
+    Integer x = a;
+    x = std::move(x) * x;
+    assert(x == a * a);
+    x = a;
+    x = x * std::move(x);
+    assert(x == a * a);
+    x = a;
+    x = std::move(x) + x;
+    assert(x == a * 2);
+    x = a;
+    x = std::move(x) - x;
+    assert(x == 0);
+    x = a;
+    x = x - std::move(x);
+    assert(x == 0);
+    x = a;
+    x = std::move(x) / x;
+    assert(x == 1);
+    x = a;
+    x = std::move(x) % x;
+    assert(x == 0);
+    x = a;
+    x = std::move(x) * std::move(x);
+    assert(x == a * a);
+  }
+}
+
+void test_rational_rvalue_operators() {
+  const Rational p(random_integer<BigInteger>(3), random_integer<BigInteger>(2));
+  const Rational q(random_integer<BigInteger>(2), random_integer<BigInteger>(3));
+  Rational copy;
+  assert((copy = p, std::move(copy) + q) == p + q && (copy = q, p + std::move(copy)) == p + q);
+  assert((copy = p, std::move(copy) - q) == p - q && (copy = q, p - std::move(copy)) == p - q);
+  assert((copy = p, std::move(copy) * q) == p * q && (copy = q, p * std::move(copy)) == p * q);
+  assert((copy = p, std::move(copy) / q) == p / q);
+  Rational x = p;
+  x = std::move(x) * x;
+  assert(x == p * p);
+  x = p;
+  x = std::move(x) - x;
+  assert(x == 0);
+  x = p;
+  x = std::move(x) / x;
+  assert(x == 1);
+}
+
+template <typename Integer>
+void test_fused_multiply_add() {
+  for (size_t len : {1, 2, 30, 400}) {
+    Integer sum = random_integer<Integer>(len + 1);
+    Integer a = random_integer<Integer>(len);
+    Integer b = random_integer<Integer>(len / 2 + 1);
+    Integer expected = sum + a * b;
+    assert(Integer(sum).addMul(a, b) == expected);
+    assert(Integer(sum).subMul(a, b) == sum - a * b);
+    assert(Integer(sum).addProduct(a, b, Sign::Negative) == sum - a * b);
+    assert(Integer(sum).addProduct(a, b, Sign::Null) == sum);
+    // сумма меняет знак и обнуляется
+    Integer product = a * b;
+    assert(Integer(product).subMul(a, b) == 0 && Integer(-product).addMul(a, b) == 0);
+    assert(Integer(1).subMul(a, a) == 1 - a * a && Integer(0).addMul(a, 0) == 0);
+    // слагаемое совпадает с множителем
+    Integer x = a;
+    x.addMul(x, x);
+    assert(x == a + a * a);
+    x = a;
+    x.subMul(x, b);
+    assert(x == a - a * b);
+
+    // скалярное произведение, как в умножении матриц
+    Integer dot = 0;
+    Integer reference = 0;
+    for (int i = 0; i < 20; i++) {
+      Integer c = random_integer<Integer>(len);
+      Integer d = random_integer<Integer>(len);
+      dot.addMul(c, d);
+      reference += c * d;
+    }
+    assert(dot == reference);
+
+    Integer mod = random_integer<Integer>(len / 3 + 1);
+    assert(mulMod(a, b, mod) == a * b % mod && mulMod(b, a, -mod) == a * b % mod);
+    assert(mulMod(a, a, mod) == a * a % mod && mulMod(a, Integer(0), mod) == 0);
+    assert(mulMod(a, b, a) == 0 && mulMod(Integer(1), b, mod) == b % mod);
+  }
+}
+
+void test_rational_fused_multiply_add() {
+  Rational a(random_integer<BigInteger>(3));
+  Rational b(random_integer<BigInteger>(2));
+  Rational c(random_integer<BigInteger>(2), random_integer<BigInteger>(1));
+  Rational sum(random_integer<BigInteger>(4));
+  assert(Rational(sum).addMul(a, b) == sum + a * b && Rational(sum).subMul(a, b) == sum - a * b);
+  assert(Rational(sum).addMul(a, c) == sum + a * c && Rational(c).subMul(c, b) == c - c * b);
+  assert(Rational(sum).addProduct(c, c, Sign::Negative) == sum - c * c);
+}
+
+// операции с одной машинной цифрой против тех же операций с BigInteger из строки
+template <typename Integer>
+void test_word_operations() {
+  const int64_t kMin = std::numeric_limits<int64_t>::min();
+  const int64_t kMax = std::numeric_limits<int64_t>::max();
+  std::vector<int64_t> words = {1, -1, 7, -7, 1000000007, -1000000007, int64_t(1) << 32, -(int64_t(1) << 32),
+                                kMax, kMin, kMin + 1};
+  std::vector<Integer> values = {0, 1, -1, 5, -5};
+  for (size_t len : {1, 2, 3, 20}) {
+    values.push_back(random_integer<Integer>(len));
+    values.push_back(random_integer<Integer>(len));
+  }
+  // перенос через все цифры и заём, укорачивающий число
+  std::vector<typename Integer::Limb> ones(3, static_cast<typename Integer::Limb>(-1));
+  Integer all_ones = Integer::fromLimbs(ones.data(), ones.size());
+  values.push_back(all_ones);
+  values.push_back(-all_ones);
+  values.push_back(all_ones + 1);
+  values.push_back(-all_ones - 1);
+  for (const Integer& value : values) {
+    for (int64_t word : words) {
+      Integer big_word(std::to_string(word));
+      uint64_t magnitude = (word < 0 ? 0 - static_cast<uint64_t>(word) : word);
+      assert(Integer(value).addWord(magnitude, word < 0 ? Sign::Negative : Sign::Positive) == value + big_word);
+      assert((Integer(value) += word) == value + big_word);
+      assert((Integer(value) -= word) == value - big_word);
+      Integer quotient = value;
+      int64_t rest = quotient.divModWord(word);
+      assert(quotient == value / big_word && Integer(std::to_string(rest)) == value % big_word);
+      assert(value.modWord(word) == rest);
+      // остаток со знаком делимого
+      assert(rest == 0 || (rest < 0) == (value < 0));
+      assert((Integer(value) /= word) == quotient && (Integer(value) %= word) == value % big_word);
+    }
+  }
+  assert(Integer(-7).modWord(2) == -1 && Integer(7).modWord(-2) == 1 && Integer(-7).divModWord(-2) == -1);
+  Integer value = Integer(std::to_string(kMin));
+  assert(value.divModWord(kMin) == 0 && value == 1);
+  value = 0;
+  value -= kMin;
+  assert(value == Integer("9223372036854775808"));
+}
+
+// одна и та же цепочка операций над обычной, ленивой и изначально несократимой дробью
+void test_lazy_rational() {
+  Rational eager(3, 7);
+  Rational lazy(3, 7);
+  lazy.setLazy(true);
+  Rational unreduced(BigInteger(6), BigInteger(14));
+  for (int step = 0; step < 200; step++) {
+    Rational term(random_integer<BigInteger>(1), random_integer<BigInteger>(1, false) + 1);
+    Rational* fractions[] = {&eager, &lazy, &unreduced};
+    for (Rational* fraction : fractions) {
+      switch (step % 5) {
+        case 0: *fraction += term; break;
+        case 1: *fraction -= term; break;
+        case 2: *fraction *= term; break;
+        case 3: *fraction /= (term == 0 ? Rational(1) : term); break;
+        case 4: fraction->addMul(term, term); break;
+      }
+    }
+    assert(eager.reduced && gcd(eager.numerator, eager.denumerator) == 1 && eager.denumerator > 0);
+    // сравнения верны и без сокращения
+    assert(lazy == eager && unreduced == eager && !(lazy < eager) && !(eager < unreduced));
+    assert(lazy.toString() == eager.toString() && lazy.asDecimal(20) == eager.asDecimal(20));
+  }
+  assert(lazy.denumerator.number.size() <= 2 * lazy.reduced_limbs + Rational::kLazyReductionLimbs);
+  unreduced.settle();
+  assert(unreduced.reduced && unreduced.numerator == eager.numerator && unreduced.denumerator == eager.denumerator);
+  lazy.setLazy(false);
+  lazy.settle();
+  assert(lazy.reduced && lazy.numerator == eager.numerator && lazy.denumerator == eager.denumerator);
+  // несократимая дробь из конструктора сокращается только при settle
+  Rational fraction(BigInteger(-10), BigInteger(-4));
+  assert(!fraction.reduced && fraction.numerator == 10 && fraction == Rational(5, 2));
+  fraction.settle();
+  assert(fraction.numerator == 5 && fraction.denumerator == 2);
+}
+
+// HybridRational против Rational на числах у границ int64_t: короткая форма переходит в длинную ровно
+// при переполнении и возвращается, как только значение снова помещается
+void test_hybrid_rational() {
+  const int64_t kMin = std::numeric_limits<int64_t>::min();
+  const int64_t kMax = std::numeric_limits<int64_t>::max();
+  HybridRational max(kMax);
+  HybridRational one(1);
+  assert(max.isSmall() && max.toString() == std::to_string(kMax));
+  HybridRational sum = max + one;
+  assert(!sum.isSmall() && sum.toString() == "9223372036854775808");
+  assert((sum - one).isSmall() && sum - one == max);
+  // INT64_MIN в коротком числителе не хранится
+  HybridRational min(kMin);
+  assert(!min.isSmall() && min == -max - one && min.toString() == std::to_string(kMin));
+  assert((min + one).isSmall() && min + one == -max);
+  assert(!(-max - one).isSmall() && (-max).isSmall());
+  assert(HybridRational(kMin, kMin) == one && HybridRational(kMin, kMin).isSmall());
+  assert(HybridRational(kMin, 2).isSmall() && HybridRational(kMin, 2) == HybridRational(kMin / 2));
+  assert(!HybridRational(1, kMin).isSmall());
+  assert(HybridRational(1, kMin) == HybridRational(-1, 2) / HybridRational(kMax / 2 + 1));
+  // переполнение в произведении и в знаменателе суммы
+  HybridRational square = max * max;
+  assert(!square.isSmall() && square / max == max && (square / max).isSmall());
+  HybridRational tiny(1, kMax);
+  HybridRational other_tiny(1, kMax - 1);
+  HybridRational tiny_sum = tiny + other_tiny;
+  assert(!tiny_sum.isSmall() && tiny_sum - other_tiny == tiny && (tiny_sum - other_tiny).isSmall());
+  assert((tiny * max).isSmall() && tiny * max == one && (max / max) == one);
+  assert(max < sum && min < -max && -sum == min && tiny < other_tiny && !(sum < max));
+
+  std::vector<int64_t> edges = {kMax, kMax - 1, kMax / 2 + 1, kMin + 1, kMin / 2, 3037000499, 3037000500,
+                                -3037000500, 1, -1, 2, 7};
+  for (int step = 0; step < 2000; step++) {
+    int64_t numer = edges[rng() % edges.size()];
+    int64_t denum = edges[rng() % edges.size()];
+    int64_t other_numer = edges[rng() % edges.size()];
+    int64_t other_denum = edges[rng() % edges.size()];
+    HybridRational a(numer, denum);
+    HybridRational b(other_numer, other_denum);
+    Rational exact_a = a.toRational();
+    Rational exact_b = b.toRational();
+    assert(exact_a == Rational(BigInteger(std::to_string(numer)), BigInteger(std::to_string(denum))));
+    HybridRational results[] = {a + b, a - b, a * b, a / b};
+    Rational expected[] = {exact_a + exact_b, exact_a - exact_b, exact_a * exact_b, exact_a / exact_b};
+    for (int i = 0; i < 4; i++) {
+      Rational value = results[i].toRational();
+      assert(value == expected[i]);
+      // короткая форма - ровно когда числитель и знаменатель помещаются
+      BigInteger limit(std::to_string(kMax));
+      bool fits = -limit <= expected[i].numerator && expected[i].numerator <= limit && expected[i].denumerator <= limit;
+      assert(results[i].isSmall() == fits);
+      assert(results[i] == HybridRational(expected[i]) && results[i].toString() == expected[i].toString());
+    }
+    assert((a < b) == (exact_a < exact_b));
+  }
+}
+
+// точное значение конечного double дробью
+Rational exact_rational(double value) {
+  int exponent;
+  double fraction = std::frexp(value, &exponent);
+  int64_t mantissa = static_cast<int64_t>(std::ldexp(fraction, 53));
+  exponent -= 53;
+  Rational result(BigInteger(std::to_string(mantissa)));
+  Rational scale(power(BigInteger(2), static_cast<uint64_t>(std::abs(exponent))));
+  return (exponent >= 0 ? result * scale : result / scale);
+}
+
+void test_to_double() {
+  const double kMaxDouble = std::numeric_limits<double>::max();
+  const double kDenormMin = std::numeric_limits<double>::denorm_min();
+  const double kMinNormal = std::numeric_limits<double>::min();
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  // много меньше любого промежутка между соседними double
+  Rational epsilon(BigInteger(1), power(BigInteger(2), 1200));
+  epsilon *= epsilon;
+  std::vector<double> values = {1.0, 0.1, 1.0 / 3, 12345.678, 1e300, 1e-300, kMaxDouble, kMinNormal,
+                                kMinNormal - kDenormMin, kDenormMin, 3 * kDenormMin, 4 * kDenormMin};
+  std::uniform_real_distribution<double> fraction(0.5, 1.0);
+  for (int i = 0; i < 200; i++) {
+    values.push_back(std::ldexp(fraction(rng), static_cast<int>(rng() % 2098) - 1073));
+  }
+  for (double value : values) {
+    for (double signed_value : {value, -value}) {
+      Rational exact = exact_rational(signed_value);
+      assert(exact.toDouble() == signed_value && HybridRational(exact).toDouble() == signed_value);
+      // середина между соседями округляется к чётной мантиссе, чуть в сторону - к ближайшему;
+      // соседом наибольшего double считается 2^1024, а округление к нему даёт бесконечность
+      double next = std::nextafter(signed_value, signed_value > 0 ? kInfinity : -kInfinity);
+      Rational exact_next = (std::isinf(next) ? exact * 2 - exact_rational(std::nextafter(signed_value, 0.0))
+                                              : exact_rational(next));
+      Rational middle = (exact + exact_next) / 2;
+      bool even = (std::bit_cast<uint64_t>(signed_value) % 2 == 0);
+      assert(middle.toDouble() == (even ? signed_value : next));
+      Rational towards = (signed_value > 0 ? epsilon : -epsilon);
+      assert((middle - towards).toDouble() == signed_value && (middle + towards).toDouble() == next);
+    }
+  }
+  // половина наименьшего денормализованного округляется к нулю, чуть больше - к нему самому
+  Rational half_denorm = exact_rational(kDenormMin) / 2;
+  assert(half_denorm.toDouble() == 0.0 && (half_denorm + epsilon).toDouble() == kDenormMin);
+  assert(std::signbit((-half_denorm).toDouble()) && (exact_rational(kDenormMin) / 3).toDouble() == 0.0);
+  // переполнение: 2^1024 и больше - бесконечность, с любым знаком
+  Rational overflow(power(BigInteger(2), 1024));
+  assert(overflow.toDouble() == kInfinity && (-overflow).toDouble() == -kInfinity);
+  assert((overflow - epsilon).toDouble() == kInfinity && (overflow * overflow).toDouble() == kInfinity);
+  assert(Rational(BigInteger(1), power(BigInteger(3), 2000)).toDouble() == 0.0);
+  assert(Rational(1, 3).toDouble() == 1.0 / 3 && Rational(-2, 7).toDouble() == -2.0 / 7);
+  assert(Rational(0).toDouble() == 0.0 && HybridRational(-5, 8).toDouble() == -0.625);
+
+  assert(Rational(1, 3).asDecimal(5) == "0.33333" && Rational(-1, 3).asDecimal(2) == "-0.33");
+  assert(Rational(-1, 3).asDecimal() == "0" && Rational(-7, 2).asDecimal() == "-3");
+  assert(Rational(7, 2).asDecimal(1) == "3.5");
+  assert(Rational(1, 100).asDecimal(3) == "0.010" && Rational(0).asDecimal(2) == "0.00");
+  assert(Rational(-1, 100).asDecimal(1) == "-0.0" && Rational(22, 7).asDecimal(10) == "3.1428571428");
+  Rational big_value(power(BigInteger(10), 40) + 1, BigInteger(4));
+  assert(big_value.asDecimal(3) == "2500000000000000000000000000000000000000.250");
+  assert(HybridRational(-22, 7).asDecimal(4) == "-3.1428");
+}
+
+// знак a - b точным перекрёстным умножением
+int reference_compare(const Rational& a, const Rational& b) {
+  BigInteger left = a.numerator * b.denumerator;
+  BigInteger right = b.numerator * a.denumerator;
+  return (left < right ? -1 : (right < left ? 1 : 0));
+}
+
+// сравнение дробей, которые отличаются на относительную величину около kError = 1e-14: на таких
+// парах плавающая оценка ничего не решает, и ответ должен дать точный путь
+void test_rational_compare() {
+  std::vector<BigInteger> scales = {BigInteger(1000), power(BigInteger(10), 13), power(BigInteger(10), 14),
+                                    power(BigInteger(10), 15), power(BigInteger(2), 46), power(BigInteger(2), 47),
+                                    power(BigInteger(10), 16), power(BigInteger(10), 40)};
+  for (size_t len : {1, 2, 5}) {
+    for (int sign : {1, -1}) {
+      Rational a(random_integer<BigInteger>(len + 1, false) * sign, random_integer<BigInteger>(len, false));
+      a.reduce();
+      for (const BigInteger& scale : scales) {
+        for (int delta : {-1, 0, 1}) {
+          // a * (scale + delta) / scale и та же дробь несокращённой
+          Rational b = a * Rational(scale + delta, scale);
+          Rational unreduced(b.numerator * 6, b.denumerator * 6);
+          for (const Rational* other : {&b, &unreduced}) {
+            int expected = reference_compare(a, *other);
+            assert(a.compare(*other) == expected && other->compare(a) == -expected);
+            assert((a == *other) == (expected == 0) && (a != *other) == (expected != 0));
+            assert((a < *other) == (expected < 0) && (a > *other) == (expected > 0));
+            assert((a <= *other) == (expected <= 0) && (a >= *other) == (expected >= 0));
+          }
+        }
+      }
+    }
+  }
+  // оценки с соседними двоичными порядками: 2^k - 1 и 2^k над одним знаменателем
+  for (uint64_t bits : {63, 64, 65, 200}) {
+    BigInteger denumerator = power(BigInteger(3), 40);
+    Rational below(power(BigInteger(2), bits) - 1, denumerator);
+    Rational exact(power(BigInteger(2), bits), denumerator);
+    assert(below < exact && exact > below && below != exact && below.compare(exact) == -1);
+    assert(Rational(-power(BigInteger(2), bits), denumerator) < -below);
+  }
+  assert(Rational(1, 3) == Rational(BigInteger(2), BigInteger(6)));
+  assert(Rational(0) == Rational(BigInteger(0), BigInteger(5)));
+  assert(Rational(-1, 3) < Rational(0) && Rational(0) < Rational(1, 1000000));
+}
+
+void test_big_int_vector() {
+  std::vector<BigInteger> values = {0, 1, -1};
+  for (size_t len : {1, 2, 3, 10, 40}) {
+    values.push_back(random_integer<BigInteger>(len));
+    values.push_back(random_integer<BigInteger>(len));
+  }
+  BigIntVector packed;
+  for (const BigInteger& value : values) {
+    packed.push_back(value);
+  }
+  assert(packed.size() == values.size() && packed.toVector() == values);
+  // у каждого числа своё место с одной запасной цифрой, места идут подряд
+  for (size_t i = 0; i < packed.size(); i++) {
+    const BigIntVector::Entry& entry = packed.entries[i];
+    assert(entry.length == values[i].number.size() && entry.capacity == entry.length + 1);
+    assert(i == 0 || entry.offset == packed.entries[i - 1].offset + packed.entries[i - 1].capacity);
+  }
+  assert(BigIntVector(values).toVector() == values);
+
+  // reserveLimbs не трогает буфер, пока места хватает
+  std::vector<BigIntVector::Entry> before = packed.entries;
+  packed.reserveLimbs([&packed](size_t i) { return packed.entries[i].capacity; });
+  for (size_t i = 0; i < packed.size(); i++) {
+    assert(packed.entries[i].offset == before[i].offset && packed.entries[i].capacity == before[i].capacity);
+  }
+  // а если одному числу не хватает, переупаковывает все
+  packed.reserveLimbs([&packed](size_t i) { return i == 3 ? size_t(100) : packed.entries[i].length; });
+  assert(packed.entries[3].capacity == 101 && packed.toVector() == values);
+  assert(packed.entries[4].offset == packed.entries[3].offset + 101);
+
+  // set с длинным числом уводит его в конец буфера, compact возвращает место
+  BigInteger long_value = random_integer<BigInteger>(120);
+  packed.set(0, long_value);
+  packed.set(1, BigInteger(-5));
+  values[0] = long_value;
+  values[1] = -5;
+  assert(packed[0] == long_value && packed.toVector() == values);
+  size_t spread = packed.limbs.size();
+  packed.compact();
+  assert(packed.limbs.size() < spread && packed.toVector() == values);
+  packed.repack([](size_t i) { return i; });
+  for (size_t i = 0; i < packed.size(); i++) {
+    assert(packed.entries[i].capacity == std::max(i, packed.entries[i].length) + 1);
+  }
+  assert(packed.toVector() == values);
+
+  // поэлементные операции против тех же операций с BigInteger
+  std::vector<BigInteger> others;
+  for (size_t i = 0; i < values.size(); i++) {
+    others.push_back(i % 4 == 0 ? -values[i] : random_integer<BigInteger>(i % 7 + 1));
+  }
+  BigIntVector other(others);
+  std::vector<int> signs = packed.compare(other);
+  for (size_t i = 0; i < values.size(); i++) {
+    assert(signs[i] == (values[i] < others[i] ? -1 : (others[i] < values[i] ? 1 : 0)));
+  }
+  packed += other;
+  for (size_t i = 0; i < values.size(); i++) {
+    assert(packed[i] == values[i] + others[i]);
+  }
+  packed -= other;
+  packed -= other;
+  for (size_t i = 0; i < values.size(); i++) {
+    assert(packed[i] == values[i] - others[i]);
+    values[i] -= others[i];
+  }
+  packed *= -7;
+  packed *= int64_t(1) << 40;
+  BigInteger total = 0;
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] *= -7;
+    values[i] *= int64_t(1) << 40;
+    assert(packed[i] == values[i]);
+    total += values[i];
+  }
+  assert(packed.sum() == total);
+  // операнд совпадает с самим вектором
+  packed += packed;
+  for (size_t i = 0; i < values.size(); i++) {
+    assert(packed[i] == values[i] * 2);
+  }
+  packed -= packed;
+  assert(packed.sum() == 0 && packed[5] == 0);
+  packed *= 0;
+  assert(packed.toVector() == std::vector<BigInteger>(values.size(), BigInteger(0)));
+}
+
+void test_binary_round_trip() {
+  std::vector<BigInteger> values = {0, 1, -1, BigInteger("18446744073709551615"), BigInteger("-18446744073709551616")};
+  for (size_t len : {1, 2, 3, 100, 20000}) {
+    values.push_back(random_integer<BigInteger>(len));
+  }
+  Rational fraction(random_integer<BigInteger>(7), random_integer<BigInteger>(5));
+  std::ostringstream stream;
+  BinaryWriter writer;
+  {
+    BinaryWriter stream_writer(stream);
+    for (const BigInteger& value : values) {
+      writer.write(value);
+      stream_writer.write(value);
+    }
+    writer.write(fraction);
+    stream_writer.write(fraction);
+  }
+  std::istringstream input(stream.str());
+  BinaryReader memory_reader(writer.buffer);
+  BinaryReader stream_reader(input);
+  for (const BigInteger& value : values) {
+    BigInteger from_memory;
+    BigInteger from_stream;
+    assert(memory_reader.read(from_memory) && from_memory == value);
+    assert(stream_reader.read(from_stream) && from_stream == value);
+  }
+  Rational from_memory;
+  Rational from_stream;
+  assert(memory_reader.read(from_memory) && from_memory == fraction);
+  assert(stream_reader.read(from_stream) && from_stream == fraction);
+  assert(memory_reader.good() && stream_reader.good());
+}
+
+void test_malformed_input() {
+  // дробь 2/4 сократима, а BinaryWriter пишет только несократимые
+  std::vector<uint8_t> fraction = {'B', 'i', 'g', 'I', 1, 2, 2, 2, 4};
+  BinaryReader fraction_reader(fraction);
+  Rational rational(5);
+  assert(!fraction_reader.read(rational) && !fraction_reader.good());
+  assert(rational == 0);
+
+  // обрезанная на любом байте запись, чужая метка и неизвестная версия
+  BinaryWriter writer;
+  writer.write(random_integer<BigInteger>(3));
+  for (size_t len = 0; len < writer.buffer.size(); len++) {
+    std::vector<uint8_t> prefix(writer.buffer.begin(), writer.buffer.begin() + len);
+    BinaryReader prefix_reader(prefix);
+    BigInteger value;
+    assert(!prefix_reader.read(value));
+  }
+  for (size_t position : {0, 4}) {
+    std::vector<uint8_t> corrupted = writer.buffer;
+    corrupted[position] ^= 0x40;
+    BinaryReader corrupted_reader(corrupted);
+    BigInteger value;
+    assert(!corrupted_reader.good() || !corrupted_reader.read(value));
+  }
+
+  // 14 байт с огромным числом слов: из памяти и из потока чтение должно просто не удаться
+  for (uint64_t count : {uint64_t(2), uint64_t(1) << 32, uint64_t(1) << 60, ~uint64_t(0) >> 1}) {
+    std::string bytes = "BigI";
+    bytes += char(1);
+    for (uint64_t tag = count << 1; ; tag >>= 7) {
+      if (tag < 0x80) {
+        bytes += char(tag);
+        break;
+      }
+      bytes += char((tag & 0x7f) | 0x80);
+    }
+    bytes.resize(14, char(0x5a));
+    std::vector<uint8_t> memory(bytes.begin(), bytes.end());
+    BinaryReader memory_reader(memory);
+    BigInteger value;
+    assert(memory_reader.good() && !memory_reader.read(value));
+    std::istringstream input(bytes);
+    BinaryReader stream_reader(input);
+    assert(stream_reader.good() && !stream_reader.read(value));
+  }
+}
+
+// все проверки, не привязанные к BigInteger, для одной политики цифр
+template <typename Integer>
+void test_policy() {
+  test_karatsuba<Integer>();
+  test_ntt<Integer>();
+  test_long_division<Integer>();
+  test_newton_division<Integer>();
+  test_decimal_conversion<Integer>();
+  test_binary_limbs<Integer>();
+  test_inline_storage<Integer>();
+  test_add_sub<Integer>();
+  test_gcd<Integer>();
+  test_pow_mod<Integer>();
+  test_simd_carries<Integer>();
+  test_parallel_multiplication<Integer>();
+  test_toom3_and_squares<Integer>();
+  test_factorial_binomial<Integer>();
+  test_roots<Integer>();
+  test_rvalue_operators<Integer>();
+  test_fused_multiply_add<Integer>();
+  test_word_operations<Integer>();
+}
+
+int main() {
+  test_karatsuba<BigInteger>();
+  std::cerr << "Test 1 (Karatsuba) passed." << std::endl;
+
+  test_ntt<BigInteger>();
+  std::cerr << "Test 2 (NTT) passed." << std::endl;
+
+  test_long_division<BigInteger>();
+  std::cerr << "Test 3 (long division) passed." << std::endl;
+
+  test_newton_division<BigInteger>();
+  std::cerr << "Test 4 (Newton division) passed." << std::endl;
+
+  test_decimal_conversion<BigInteger>();
+  std::cerr << "Test 5 (decimal conversion) passed." << std::endl;
+
+  test_binary_limbs<BigInteger>();
+  std::cerr << "Test 6 (binary limbs) passed." << std::endl;
+
+  test_inline_storage<BigInteger>();
+  std::cerr << "Test 7 (inline storage) passed." << std::endl;
+
+  test_add_sub<BigInteger>();
+  std::cerr << "Test 8 (addition and subtraction) passed." << std::endl;
+
+  test_gcd<BigInteger>();
+  test_rational_normalization();
+  std::cerr << "Test 9 (gcd) passed." << std::endl;
+
+  test_pow_mod<BigInteger>();
+  std::cerr << "Test 10 (powMod) passed." << std::endl;
+
+  test_simd_carries<BigInteger>();
+  std::cerr << "Test 11 (AVX2 carries) passed." << std::endl;
+
+  test_parallel_multiplication<BigInteger>();
+  std::cerr << "Test 12 (parallel multiplication) passed." << std::endl;
+
+  test_toom3_and_squares<BigInteger>();
+  std::cerr << "Test 13 (Toom-3 and squaring) passed." << std::endl;
+
+  test_factorial_binomial<BigInteger>();
+  std::cerr << "Test 14 (factorial and binomial) passed." << std::endl;
+
+  test_roots<BigInteger>();
+  std::cerr << "Test 15 (roots and perfect powers) passed." << std::endl;
+
+  test_rvalue_operators<BigInteger>();
+  test_rational_rvalue_operators();
+  std::cerr << "Test 16 (rvalue operators) passed." << std::endl;
+
+  test_fused_multiply_add<BigInteger>();
+  test_rational_fused_multiply_add();
+  std::cerr << "Test 17 (addMul and mulMod) passed." << std::endl;
+
+  test_word_operations<BigInteger>();
+  std::cerr << "Test 18 (single-word operations) passed." << std::endl;
+
+  test_lazy_rational();
+  std::cerr << "Test 19 (lazy Rational) passed." << std::endl;
+
+  test_hybrid_rational();
+  std::cerr << "Test 20 (HybridRational) passed." << std::endl;
+
+  test_to_double();
+  std::cerr << "Test 21 (toDouble and asDecimal) passed." << std::endl;
+
+  test_rational_compare();
+  std::cerr << "Test 22 (Rational comparison) passed." << std::endl;
+
+  test_big_int_vector();
+  std::cerr << "Test 23 (BigIntVector) passed." << std::endl;
+
+  test_binary_round_trip();
+  test_malformed_input();
+  std::cerr << "Test 24 (binary format) passed." << std::endl;
+
+  test_policy<BasicBigInteger<Limbs32>>();
+#ifdef __SIZEOF_INT128__
+  test_policy<BasicBigInteger<Limbs64>>();
+#endif
+  std::cerr << "Test 25 (32- and 64-bit limbs) passed." << std::endl;
+
+  std::cout << 0;
+}
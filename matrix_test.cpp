@@ -0,0 +1,93 @@
+#include <iostream>
+#include <string>
+#include <cassert>
+
+#include "matrix.h"
+
+// матрица Гильберта: h[i][j] = 1 / (i + j + 1), определитель и обратная известны точно
+template <size_t N>
+SquareMatrix<N> hilbert() {
+  SquareMatrix<N> matrix;
+  for (size_t i = 0; i < N; i++) {
+    for (size_t j = 0; j < N; j++) {
+      matrix[i][j] = Rational(1, static_cast<int>(i + j + 1));
+    }
+  }
+  return matrix;
+}
+
+void test_determinant() {
+  SquareMatrix<3> matrix = {{2, -3, 1}, {2, 0, -1}, {1, 4, 5}};
+  assert(matrix.det() == Rational(49));
+  // нулевой ведущий элемент
+  SquareMatrix<2> swapped = {{0, 1}, {1, 0}};
+  assert(swapped.det() == Rational(-1));
+  SquareMatrix<3> singular = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+  assert(singular.det() == Rational(0));
+  assert(hilbert<4>().det() == Rational(1, 6048000));
+  // знаменатель не помещается в int64_t
+  assert(hilbert<8>().det() == Rational(BigInteger(1), BigInteger("365356847125734485878112256000000")));
+  SquareMatrix<3, Residue<7>> residues = {{2, -3, 1}, {2, 0, -1}, {1, 4, 5}};
+  SquareMatrix<2, Residue<7>> residue_swapped = {{0, 1}, {1, 0}};
+  assert(residues.det() == Residue<7>(0) && residue_swapped.det() == Residue<7>(6));
+}
+
+void test_rank() {
+  SquareMatrix<3> singular = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+  assert(singular.rank() == 2);
+  SquareMatrix<4> two = {{1, 2, 3, 4}, {2, 4, 6, 8}, {0, 1, 1, 1}, {1, 3, 4, 5}};
+  assert(two.rank() == 2);
+  assert(SquareMatrix<3>::unityMatrix().rank() == 3 && SquareMatrix<3>().rank() == 0);
+  assert(hilbert<5>().rank() == 5);
+}
+
+void test_inverse() {
+  SquareMatrix<3> matrix = {{2, -3, 1}, {2, 0, -1}, {1, 4, 5}};
+  SquareMatrix<3> inverse = matrix.inverted();
+  assert(matrix * inverse == SquareMatrix<3>::unityMatrix() && inverse * matrix == SquareMatrix<3>::unityMatrix());
+  assert(inverse[0][0] == Rational(4, 49) && inverse[2][0] == Rational(8, 49));
+  // обратная к матрице Гильберта целочисленна
+  SquareMatrix<4> expected = {{16, -120, 240, -140}, {-120, 1200, -2700, 1680}, {240, -2700, 6480, -4200},
+                              {-140, 1680, -4200, 2800}};
+  assert(hilbert<4>().inverted() == expected);
+  SquareMatrix<4> inverted = expected;
+  inverted.invert();
+  assert(inverted == hilbert<4>() && inverted.det() * expected.det() == Rational(1));
+  SquareMatrix<2> swapped = {{0, 1}, {1, 0}};
+  assert(swapped.inverted() == swapped);
+}
+
+void test_product() {
+  // произведение копит суммы через addMul: целые дроби, дроби и большие числа
+  SquareMatrix<2> matrix = {{1, 2}, {3, 4}};
+  SquareMatrix<2> expected = {{7, 10}, {15, 22}};
+  assert(matrix * matrix == expected);
+  SquareMatrix<2> power = SquareMatrix<2>::unityMatrix();
+  SquareMatrix<2> fibonacci = {{1, 1}, {1, 0}};
+  for (int i = 0; i < 300; i++) {
+    power *= fibonacci;
+  }
+  assert(power[0][1] == Rational(BigInteger("222232244629420445529739893461909967206666939096499764990979600")));
+  assert(power[0][0] * power[1][1] - power[0][1] * power[1][0] == Rational(1));
+  assert(hilbert<3>() * hilbert<3>().inverted() == SquareMatrix<3>::unityMatrix());
+  Matrix<2, 3> wide = {{1, 0, 2}, {0, 1, 3}};
+  Matrix<3, 2> tall = wide.transposed();
+  Matrix<2, 2> gram = {{5, 6}, {6, 10}};
+  assert(wide * tall == gram && gram.trace() == Rational(15));
+}
+
+int main() {
+  test_determinant();
+  std::cerr << "Test 1 (determinant) passed." << std::endl;
+
+  test_rank();
+  std::cerr << "Test 2 (rank) passed." << std::endl;
+
+  test_inverse();
+  std::cerr << "Test 3 (inverse) passed." << std::endl;
+
+  test_product();
+  std::cerr << "Test 4 (product) passed." << std::endl;
+
+  std::cout << 0;
+}